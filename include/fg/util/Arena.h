@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#pragma once
+#include "Common.h"
+#include <memory_resource>
+
+namespace fog
+{
+    /**
+     * Monotonic arena of objects, memory is only reclaimed in one shot by release() or the
+     * destructor, which also destroy all objects made in the arena in reverse order.
+     */
+    struct Arena
+    {
+        explicit Arena(std::size_t initialSize = 4096) : resource(initialSize), destructors(&resource)
+        {
+        }
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        ~Arena()
+        {
+            release();
+        }
+
+        template <typename T, typename... Args>
+        T *make(Args &&...args)
+        {
+            void *mem;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                mem = resource.allocate(sizeof(T), alignof(T));
+            }
+            T *ptr;
+            if constexpr (sizeof...(Args) == 0)
+            {
+                ptr = new (mem) T{};
+            }
+            else
+            {
+                ptr = new (mem) T(std::forward<Args>(args)...);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                destructors.push_back(Destructor{ptr, [](void *p)
+                                                 { static_cast<T *>(p)->~T(); }});
+            }
+            objects++;
+            bytes += sizeof(T);
+            return ptr;
+        }
+
+        void release()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto it = destructors.rbegin(); it != destructors.rend(); it++)
+            {
+                it->destroy(it->ptr);
+            }
+            destructors = std::pmr::vector<Destructor>(&resource); // before the memory of it released.
+            resource.release();
+            objects = 0;
+            bytes = 0;
+        }
+
+        std::size_t getObjects() const
+        {
+            return objects;
+        }
+
+        std::size_t getBytes() const
+        {
+            return bytes;
+        }
+
+    private:
+        struct Destructor
+        {
+            void *ptr;
+            void (*destroy)(void *);
+        };
+
+        std::mutex mutex;
+        std::pmr::monotonic_buffer_resource resource;
+        std::pmr::vector<Destructor> destructors;
+        std::size_t objects = 0;
+        std::size_t bytes = 0;
+    };
+};
@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#pragma once
+#include "Common.h"
+#include <cstdint>
+#include <new>
+
+namespace fog
+{
+    /**
+     * Owning span of instances constructed in one contiguous allocation, they are destroyed and
+     * the memory released together with the batch.
+     */
+    template <typename T>
+    struct Batch
+    {
+        Batch() = default;
+
+        // take the ownership of count constructed instances in memory from allocate().
+        Batch(T *ptr, std::size_t count) : ptr(ptr), count(count)
+        {
+        }
+
+        Batch(const Batch &) = delete;
+        Batch &operator=(const Batch &) = delete;
+
+        Batch(Batch &&other) : ptr(other.ptr), count(other.count)
+        {
+            other.ptr = nullptr;
+            other.count = 0;
+        }
+
+        Batch &operator=(Batch &&other)
+        {
+            if (this != &other)
+            {
+                clear();
+                std::swap(ptr, other.ptr);
+                std::swap(count, other.count);
+            }
+            return *this;
+        }
+
+        ~Batch()
+        {
+            clear();
+        }
+
+        T *data() const
+        {
+            return ptr;
+        }
+
+        std::size_t size() const
+        {
+            return count;
+        }
+
+        bool empty() const
+        {
+            return count == 0;
+        }
+
+        T *begin() const
+        {
+            return ptr;
+        }
+
+        T *end() const
+        {
+            return ptr + count;
+        }
+
+        T &operator[](std::size_t i) const
+        {
+            return ptr[i];
+        }
+
+        static T *allocate(std::size_t count)
+        {
+            if (count > SIZE_MAX / sizeof(T))
+            {
+                throw std::bad_array_new_length();
+            }
+            return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+        }
+
+        static void deallocate(T *ptr)
+        {
+            ::operator delete(ptr, std::align_val_t(alignof(T)));
+        }
+
+    private:
+        T *ptr = nullptr;
+        std::size_t count = 0;
+
+        void clear()
+        {
+            if (!ptr)
+            {
+                return;
+            }
+            for (std::size_t i = 0; i < count; i++)
+            {
+                ptr[i].~T();
+            }
+            deallocate(ptr);
+            ptr = nullptr;
+            count = 0;
+        }
+    };
+};
@@ -17,4 +17,8 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <fmt/format.h>
-#include <stack>
\ No newline at end of file
+#include <stack>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <future>
\ No newline at end of file
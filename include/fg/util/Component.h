@@ -7,6 +7,13 @@
 #include "Common.h"
 #include "Options.h"
 #include "ConfigMembers.h"
+#include "Provider.h"
+#include "Lazy.h"
+#include "TypeIds.h"
+#include "Arena.h"
+#include "WorkerPool.h"
+#include "Trace.h"
+#include "Wiring.h"
 
 #define INJECT(Sig)     \
     using Inject = Sig; \
@@ -40,17 +47,74 @@
 
 #define MEMBERKD(mname, key, dftV) MEMBERX(mname, (key, dftV))
 
-#define INIT(mname)                                                           \
-    struct AutoRegisteredInit_##mname                                         \
-    {                                                                         \
-        AutoRegisteredInit_##mname()                                          \
-        {                                                                     \
-            AutoRegisteredObjects::getInstance().addInit<Self>(&Self::mname); \
-        };                                                                    \
-    };                                                                        \
-    static inline AutoRegisteredInit_##mname autoRegisteredInit_##mname{};    \
+#define INIT(mname)                                                                   \
+    struct AutoRegisteredInit_##mname                                                 \
+    {                                                                                 \
+        AutoRegisteredInit_##mname()                                                  \
+        {                                                                             \
+            AutoRegisteredObjects::getInstance().addInit<Self>(&Self::mname, #mname); \
+        };                                                                            \
+    };                                                                                \
+    static inline AutoRegisteredInit_##mname autoRegisteredInit_##mname{};            \
     void mname
 
+#define INIT_ASYNC(mname)                                                            \
+    struct AutoRegisteredInitAsync_##mname                                           \
+    {                                                                                \
+        AutoRegisteredInitAsync_##mname()                                            \
+        {                                                                            \
+            AutoRegisteredObjects::getInstance().addInitAsync<Self>(&Self::mname);   \
+        };                                                                           \
+    };                                                                               \
+    static inline AutoRegisteredInitAsync_##mname autoRegisteredInitAsync_##mname{}; \
+    void mname
+
+#define RESET(mname)                                                           \
+    struct AutoRegisteredReset_##mname                                         \
+    {                                                                          \
+        AutoRegisteredReset_##mname()                                          \
+        {                                                                      \
+            AutoRegisteredObjects::getInstance().addReset<Self>(&Self::mname); \
+        };                                                                     \
+    };                                                                         \
+    static inline AutoRegisteredReset_##mname autoRegisteredReset_##mname{};   \
+    void mname
+
+#define DESTROY(mname)                                                           \
+    struct AutoRegisteredDestroy_##mname                                         \
+    {                                                                            \
+        AutoRegisteredDestroy_##mname()                                          \
+        {                                                                        \
+            AutoRegisteredObjects::getInstance().addDestroy<Self>(&Self::mname); \
+        };                                                                       \
+    };                                                                           \
+    static inline AutoRegisteredDestroy_##mname autoRegisteredDestroy_##mname{}; \
+    void mname
+
+/**
+ * Member table of the class as alternative of the macros above, nothing is registered at static
+ * init time, e.g.: FIELDS(FIELDK(speed, "speed"), FIELDD(scale, 1.5f), ON_INIT(init)), after
+ * the declarations of the members. The macros above are ignored for a class with the table.
+ */
+#define FIELDS(...) \
+    static constexpr auto Fields = std::make_tuple(__VA_ARGS__);
+
+#define FIELDX(mname, args) ::fog::field(#mname, &Self::mname, REMOVE_PARENS(args))
+
+#define FIELDK(mname, key) FIELDX(mname, (key))
+
+#define FIELDD(mname, dftV) FIELDX(mname, (#mname, dftV))
+
+#define FIELDKD(mname, key, dftV) FIELDX(mname, (key, dftV))
+
+#define ON_INIT(mname) ::fog::method<::fog::MethodKind::Init>(&Self::mname, #mname)
+
+#define ON_INIT_ASYNC(mname) ::fog::method<::fog::MethodKind::InitAsync>(&Self::mname)
+
+#define ON_RESET(mname) ::fog::method<::fog::MethodKind::Reset>(&Self::mname)
+
+#define ON_DESTROY(mname) ::fog::method<::fog::MethodKind::Destroy>(&Self::mname)
+
 namespace fog
 {
 
@@ -89,6 +153,63 @@ namespace fog
         using type = std::tuple<T, Ts...>;
     };
 
+    struct NoDefault
+    {
+    };
+
+    // entry of the member table, the default value D is converted to F when used.
+    template <typename T, typename F, typename D = NoDefault>
+    struct Field
+    {
+        const char *name;
+        const char *key;
+        F T::*member;
+        D dftVal;
+    };
+
+    template <typename T, typename F>
+    constexpr Field<T, F> field(const char *name, F T::*member, const char *key)
+    {
+        return Field<T, F>{name, key, member, NoDefault{}};
+    }
+
+    template <typename T, typename F, typename D>
+    constexpr Field<T, F, D> field(const char *name, F T::*member, const char *key, D dftVal)
+    {
+        return Field<T, F, D>{name, key, member, dftVal};
+    }
+
+    enum class MethodKind
+    {
+        Init,
+        InitAsync,
+        Reset,
+        Destroy
+    };
+
+    template <typename T, MethodKind K>
+    struct Method
+    {
+        void (T::*method)();
+        const char *name;
+    };
+
+    template <MethodKind K, typename T>
+    constexpr Method<T, K> method(void (T::*method)(), const char *name = "")
+    {
+        return Method<T, K>{method, name};
+    }
+
+    template <typename T, typename = void>
+    struct hasFields : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct hasFields<T, std::void_t<decltype(T::Fields)>> : std::true_type
+    {
+    };
+
     struct AutoRegisteredObjects
     {
         struct MemberInfo
@@ -96,66 +217,210 @@ namespace fog
             bool asPtr;
             std::type_index pType;
             std::type_index vType;
-            std::function<void(std::any, std::any)> setter;
             std::string key;
             std::function<bool(std::any &)> defaultVal;
+            // typed access without boxing, src is the pointer itself for pointer member, the address of value otherwise.
+            std::function<void(void *obj, void *src)> assign;
+            std::function<void *(std::any &)> srcOf;   // src of a value of the member type.
+            std::function<void *(const std::any &)> ptrOf; // vType * in the any, as void *.
+            // for member of Lazy<X> only, lazyType is X, makes the lazy from the static usage of X.
+            std::type_index lazyType;
+            std::function<std::any(std::function<std::any()>)> makeLazy;
             MemberInfo(bool asPtr, std::type_index pType, std::type_index vType, //
-                       std::function<void(std::any, std::any)> setter,
                        std::string key,
                        std::function<bool(std::any &)> defaultVal) : //
-                                                                     asPtr(asPtr), pType(pType), vType(vType), setter(setter), key(key), defaultVal(defaultVal)
+                                                                     asPtr(asPtr), pType(pType), vType(vType), key(key), defaultVal(defaultVal), lazyType(vType)
             {
             }
         };
         struct MethodInfo
         {
-            std::function<void(std::any)> method;
-            MethodInfo(std::function<void(std::any)> method) : method(method)
+            std::function<void(void *)> invoke; // typed, no boxing.
+            std::string name;                   // of the method, if known.
+            MethodInfo(std::function<void(void *)> invoke) : invoke(invoke)
             {
             }
         };
         struct ObjectInfo
         {
-            std::unordered_map<std::string, MemberInfo> members;
+            std::vector<std::pair<std::string, MemberInfo>> members; // in order of registration.
             std::vector<MethodInfo> inits;
+            std::vector<MethodInfo> resets; // re-initialize a pooled instance before reusing it.
+            std::vector<MethodInfo> destroys; // teardown of a static instance before it's deleted by shutdown.
+            std::vector<MethodInfo> asyncInits; // run by the worker pool of injector after inits.
         };
 
         std::unordered_map<std::type_index, ObjectInfo> objects;
 
+        /**
+         * Registered members and methods of T, from the member table of T if it has one(built on
+         * the first call), otherwise from the registration of the macros, null if none.
+         */
+        template <typename T>
+        static const ObjectInfo *find()
+        {
+            if constexpr (hasFields<T>::value)
+            {
+                static const ObjectInfo objInfo = makeObjectInfo<T>();
+                return &objInfo;
+            }
+            else
+            {
+                AutoRegisteredObjects &autoRegObjs = getInstance();
+                auto itObj = autoRegObjs.objects.find(std::type_index(typeid(T)));
+                return itObj == autoRegObjs.objects.end() ? nullptr : &itObj->second;
+            }
+        }
+
         template <typename T, typename F>
         void addMember(const std::string &fieldName, F T::*member, const std::string &key)
         {
             auto func = [](std::any &dftV)
             { return false; };
-            doAddMember<T, F>(fieldName, member, key, func);
+            doAddMember<T, F>(objects[std::type_index(typeid(T))], fieldName, member, key, func);
         }
         template <typename T, typename F>
         void addMember(const std::string &fieldName, F T::*member, const std::string &key, F dftVal)
         {
             std::function<bool(std::any &)> dftFunc;
             makeDefaultValFunction<F>(dftVal, dftFunc);
-            doAddMember<T, F>(fieldName, member, key, dftFunc);
+            doAddMember<T, F>(objects[std::type_index(typeid(T))], fieldName, member, key, dftFunc);
+        }
+
+        template <typename T, typename F>
+        void addInit(F T::*init, const std::string &name = "")
+        {
+            doAddInit<T, F>(objects[std::type_index(typeid(T))], init, name);
+        }
+
+        template <typename T, typename F>
+        void addInitAsync(F T::*init)
+        {
+            doAddInitAsync<T, F>(objects[std::type_index(typeid(T))], init);
+        }
+
+        template <typename T, typename F>
+        void addReset(F T::*reset)
+        {
+            doAddReset<T, F>(objects[std::type_index(typeid(T))], reset);
         }
 
         template <typename T, typename F>
-        void doAddMember(const std::string &fieldName, F T::*member, const std::string &key, std::function<bool(std::any &)> dftFunc)
+        void addDestroy(F T::*destroy)
+        {
+            doAddDestroy<T, F>(objects[std::type_index(typeid(T))], destroy);
+        }
+
+        static AutoRegisteredObjects &getInstance()
+        {
+            static AutoRegisteredObjects instance;
+            return instance;
+        }
+
+    private:
+        template <typename T>
+        static ObjectInfo makeObjectInfo()
+        {
+            ObjectInfo objInfo;
+            std::apply([&objInfo](const auto &...entries)
+                       { (addEntry(objInfo, entries), ...); },
+                       T::Fields);
+            return objInfo;
+        }
+
+        template <typename T, typename F>
+        static void addEntry(ObjectInfo &objInfo, const Field<T, F> &entry)
+        {
+            auto func = [](std::any &dftV)
+            { return false; };
+            doAddMember<T, F>(objInfo, entry.name, entry.member, entry.key, func);
+        }
+
+        template <typename T, typename F, typename D>
+        static void addEntry(ObjectInfo &objInfo, const Field<T, F, D> &entry)
+        {
+            std::function<bool(std::any &)> dftFunc;
+            makeDefaultValFunction<F>(F(entry.dftVal), dftFunc);
+            doAddMember<T, F>(objInfo, entry.name, entry.member, entry.key, dftFunc);
+        }
+
+        template <typename T, MethodKind K>
+        static void addEntry(ObjectInfo &objInfo, const Method<T, K> &entry)
+        {
+            if constexpr (K == MethodKind::Init)
+            {
+                doAddInit<T>(objInfo, entry.method, entry.name);
+            }
+            else if constexpr (K == MethodKind::InitAsync)
+            {
+                doAddInitAsync<T>(objInfo, entry.method);
+            }
+            else if constexpr (K == MethodKind::Reset)
+            {
+                doAddReset<T>(objInfo, entry.method);
+            }
+            else
+            {
+                doAddDestroy<T>(objInfo, entry.method);
+            }
+        }
+
+        template <typename T, typename F>
+        static void doAddMember(ObjectInfo &objInfo, const std::string &fieldName, F T::*member, const std::string &key, std::function<bool(std::any &)> dftFunc)
         {
-            auto &objInfo = objects[std::type_index(typeid(T))];
             bool isPtr = std::is_pointer_v<F>;
             std::type_index vType = isPtr ? typeid(std::remove_pointer_t<F>) : typeid(F);
             std::type_index pType = isPtr ? typeid(F) : typeid(F *);
-            objInfo.members.emplace(fieldName, MemberInfo(isPtr, pType, vType, [member](std::any obj, std::any value)
-                                                          {
-                                                              // we trust the value provided here is type match
-                                                              T *tObj = std::any_cast<T *>(obj);
-                                                              F val = std::any_cast<F>(value);
-                                                              tObj->*member = val; //
-                                                          },
-                                                          key, dftFunc));
+            using V = std::remove_pointer_t<F>;
+            for (const auto &pair : objInfo.members)
+            {
+                if (pair.first == fieldName)
+                {
+                    throw std::runtime_error("member:" + fieldName + " is already registered.");
+                }
+            }
+            auto &it = objInfo.members.emplace_back(fieldName, MemberInfo(isPtr, pType, vType, key, dftFunc));
+            MemberInfo &mebInfo = it.second;
+            mebInfo.assign = [member](void *obj, void *src)
+            {
+                if constexpr (std::is_pointer_v<F>)
+                {
+                    static_cast<T *>(obj)->*member = static_cast<F>(src);
+                }
+                else
+                {
+                    static_cast<T *>(obj)->*member = *static_cast<F *>(src);
+                }
+            };
+            mebInfo.srcOf = [](std::any &value) -> void *
+            {
+                if constexpr (std::is_pointer_v<F>)
+                {
+                    return const_cast<std::remove_cv_t<V> *>(std::any_cast<F>(value));
+                }
+                else
+                {
+                    return std::any_cast<F>(&value);
+                }
+            };
+            mebInfo.ptrOf = [](const std::any &value) -> void *
+            {
+                return const_cast<std::remove_cv_t<V> *>(std::any_cast<V *>(value));
+            };
+            if constexpr (isLazy<F>::value)
+            {
+                using X = typename isLazy<F>::Type;
+                mebInfo.lazyType = typeid(X);
+                mebInfo.makeLazy = [](std::function<std::any()> usage) -> std::any
+                {
+                    return std::make_any<F>([usage]()
+                                            { return std::any_cast<X *>(usage()); });
+                };
+            }
         }
 
         template <typename T>
-        typename std::enable_if_t<!std::is_pointer_v<T>, void> makeDefaultValFunction(T dftV, std::function<bool(std::any &)> &func)
+        static typename std::enable_if_t<!std::is_pointer_v<T>, void> makeDefaultValFunction(T dftV, std::function<bool(std::any &)> &func)
         {
 
             func = [dftV](std::any &retVal)
@@ -166,7 +431,7 @@ namespace fog
         }
 
         template <typename T>
-        typename std::enable_if_t<std::is_pointer_v<T>, void> makeDefaultValFunction(T dftV, std::function<bool(std::any &)> &func)
+        static typename std::enable_if_t<std::is_pointer_v<T>, void> makeDefaultValFunction(T dftV, std::function<bool(std::any &)> &func)
         {
 
             func = [dftV](std::any &retVal)
@@ -181,29 +446,146 @@ namespace fog
         }
 
         template <typename T, typename F>
-        void addInit(F T::*init)
+        static void doAddInit(ObjectInfo &objInfo, F T::*init, const std::string &name)
         {
-            auto &objInfo = objects[std::type_index(typeid(T))];
-
-            MethodInfo methodInfo([init](std::any obj)
-                                  {
-                                      T *tObj = std::any_cast<T *>(obj);
-                                      (tObj->*init)(); //
-                                  });
+            MethodInfo methodInfo([init](void *obj)
+                                  { (static_cast<T *>(obj)->*init)(); });
             if (objInfo.inits.size() > 0)
             {
                 throw std::runtime_error("only support single init method, there are already one registered.");
             }
+            methodInfo.name = name;
             objInfo.inits.emplace_back(methodInfo);
         }
 
-        static AutoRegisteredObjects &getInstance()
+        template <typename T, typename F>
+        static void doAddInitAsync(ObjectInfo &objInfo, F T::*init)
         {
-            static AutoRegisteredObjects instance;
-            return instance;
+            MethodInfo methodInfo([init](void *obj)
+                                  { (static_cast<T *>(obj)->*init)(); });
+            if (objInfo.asyncInits.size() > 0)
+            {
+                throw std::runtime_error("only support single async init method, there are already one registered.");
+            }
+            objInfo.asyncInits.emplace_back(methodInfo);
+        }
+
+        template <typename T, typename F>
+        static void doAddReset(ObjectInfo &objInfo, F T::*reset)
+        {
+            MethodInfo methodInfo([reset](void *obj)
+                                  { (static_cast<T *>(obj)->*reset)(); });
+            if (objInfo.resets.size() > 0)
+            {
+                throw std::runtime_error("only support single reset method, there are already one registered.");
+            }
+            objInfo.resets.emplace_back(methodInfo);
+        }
+
+        template <typename T, typename F>
+        static void doAddDestroy(ObjectInfo &objInfo, F T::*destroy)
+        {
+            MethodInfo methodInfo([destroy](void *obj)
+                                  { (static_cast<T *>(obj)->*destroy)(); });
+            if (objInfo.destroys.size() > 0)
+            {
+                throw std::runtime_error("only support single destroy method, there are already one registered.");
+            }
+            objInfo.destroys.emplace_back(methodInfo);
         }
     }; // end of class
 
+    template <typename T>
+    struct isUniquePtr : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct isUniquePtr<std::unique_ptr<T>> : std::true_type
+    {
+    };
+
+    template <typename T>
+    struct isSharedPtr : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct isSharedPtr<std::shared_ptr<T>> : std::true_type
+    {
+    };
+
+    enum class ArgKind
+    {
+        Pointer,
+        Reference,
+        Value,
+        Provider,
+        Lazy,
+        Unique,
+        Shared
+    };
+
+    /**
+     * How a argument of INJECT constructor is resolved, Type is the bound type the argument is
+     * resolved from, eager means the static instance of it must exist before the constructor is
+     * called, fresh means a new instance is created for each injection(by value or unique_ptr).
+     */
+    template <typename Arg>
+    struct InjectedArg
+    {
+        using Type = std::remove_cv_t<std::remove_pointer_t<std::remove_reference_t<Arg>>>;
+        static constexpr bool eager = std::is_pointer_v<Arg> || std::is_reference_v<Arg>;
+        static constexpr bool fresh = !eager;
+        static constexpr ArgKind kind = std::is_pointer_v<Arg> ? ArgKind::Pointer : std::is_reference_v<Arg> ? ArgKind::Reference
+                                                                                                           : ArgKind::Value;
+    };
+
+    template <typename T>
+    struct InjectedArg<Provider<T>>
+    {
+        using Type = T;
+        static constexpr bool eager = false;
+        static constexpr bool fresh = false;
+        static constexpr ArgKind kind = ArgKind::Provider;
+    };
+
+    template <typename T>
+    struct InjectedArg<Lazy<T>>
+    {
+        using Type = T;
+        static constexpr bool eager = false;
+        static constexpr bool fresh = false;
+        static constexpr ArgKind kind = ArgKind::Lazy;
+    };
+
+    template <typename T>
+    struct InjectedArg<std::unique_ptr<T>>
+    {
+        using Type = T;
+        static constexpr bool eager = false;
+        static constexpr bool fresh = true;
+        static constexpr ArgKind kind = ArgKind::Unique;
+    };
+
+    template <typename T>
+    struct InjectedArg<std::shared_ptr<T>>
+    {
+        using Type = T;
+        static constexpr bool eager = false;
+        static constexpr bool fresh = false;
+        static constexpr ArgKind kind = ArgKind::Shared;
+    };
+
+    struct PoolStats
+    {
+        std::size_t hits = 0;     // acquired from the free list.
+        std::size_t misses = 0;   // created since the free list is empty.
+        std::size_t releases = 0; // returned to the free list.
+        std::size_t drops = 0;    // destroyed on release since the free list is full.
+        std::size_t idle = 0;     // in the free list for now.
+    };
+
     template <typename T, typename C>
     struct ArgOfConstructor
     {
@@ -233,21 +615,23 @@ namespace fog
         }
 
         template <typename T, typename Imp, typename Tuple, std::size_t... Is>
-        static Component make(UsageFunc createAsS, UsageFunc createAsD, std::index_sequence<Is...>, //
+        static Component make(std::function<T *()> createAsS, std::function<T *()> createAsD, std::index_sequence<Is...>, //
                               FieldsFunc fields)
         {
             Object objS; // map from type id => function to get/crate the required type of value.
+            Raw rawS;    // same as above but typed, returns the pointer of the type as void *.
             if (createAsS)
             {
-                ((registerInterface<T, Imp, Tuple, Is>(objS, createAsS)), ...);
+                ((registerInterface<T, Imp, Tuple, Is>(objS, rawS, createAsS)), ...);
             }
             Object objD; // map from type id => function to get/crate the required type of value.
+            Raw rawD;
             if (createAsD)
             {
-                ((registerInterface<T, Imp, Tuple, Is>(objD, createAsD)), ...);
+                ((registerInterface<T, Imp, Tuple, Is>(objD, rawD, createAsD)), ...);
             }
 
-            return Component(typeid(T), objS, objD, fields);
+            return Component(typeid(T), objS, objD, rawS, rawD, fields);
         }
         
         template <typename T, typename Imp, typename AdtsTuple, typename IJ>
@@ -281,6 +665,8 @@ namespace fog
 
         using Interface = std::unordered_set<std::type_index>;
         using Object = std::unordered_map<std::type_index, UsageFunc>;
+        using PtrFunc = std::function<void *()>;
+        using Raw = std::unordered_map<std::type_index, PtrFunc>;
         using Value = UsageFunc;
         using Members = FieldsFunc;
 
@@ -296,11 +682,156 @@ namespace fog
         std::type_index typeId; // register the main type of the component.
         Object objS;            // cast funcs
         Object objD;            // cast funcs
+        Raw rawS;               // typed cast funcs, no std::any boxing.
+        Raw rawD;               // typed cast funcs, no std::any boxing.
+        bool singleton = false; // static usage always returns the same instance, the injector may cache it.
+
+        /**
+         * A constructor argument the component depends on, it's resolved from the component of
+         * type, or from the component of fallback(ArgOfConstructor) if type is not bound.
+         */
+        struct Dependency
+        {
+            std::type_index type;
+            std::type_index fallback;
+            bool eager;
+            ArgKind kind;
+        };
+        std::vector<Dependency> dependencies; // of the INJECT constructor, empty for component not made by impl.
+        struct State;
+        // dynamic instance of the main type created by the injector scope(the IJ) and allocated from the arena(heap if null), only for component made by impl.
+        // ready is set to the future of its async inits if not null.
+        void *(*createIn)(void *ij, State &state, Arena *arena, std::shared_future<void> *ready) = nullptr;
+        std::type_index implType;             // key of the registered members and inits.
+        const AutoRegisteredObjects::ObjectInfo *(*objectInfo)() = nullptr; // registered members and inits of the impl.
 
         Members members;
         friend struct Injector;
+
+        /**
+         * Member injection and init of a impl type compiled once per injector, executing it does
+         * no string building and no std::any traffic. Only the source of a config member is
+         * compiled, its option is looked up by the pre-hashed key when injecting, so instances
+         * created after the config changed get the new value.
+         */
+        struct InjectionPlan
+        {
+            struct Step
+            {
+                const AutoRegisteredObjects::MemberInfo *member = nullptr;
+                PtrFunc source;      // the bound component the member resolved from.
+                ConfigSource config; // or the option of config, read when injecting.
+                std::any value;      // default value, if the option does not exist.
+                void *src = nullptr;
+            };
+            const std::type_info *type = nullptr; // the impl type.
+            std::vector<Step> steps;
+            std::vector<std::function<void(void *)>> inits;
+            std::vector<std::function<void(void *)>> resets;
+            std::vector<std::function<void(void *)>> asyncInits;
+            std::vector<std::function<void(void *)>> destroys;
+        };
+
+        /**
+         * Free list of dynamic instances of a pooled component, instances are kept as pointer of
+         * the impl type and always allocated from heap.
+         */
+        struct Pool
+        {
+            std::size_t limit;
+            void (*destroy)(void *);    // delete a impl instance.
+            void *(*toImpl)(void *);    // main type pointer => impl pointer.
+            std::mutex mutex;
+            std::vector<void *> free;
+            PoolStats stats;
+
+            Pool(std::size_t limit, void (*destroy)(void *), void *(*toImpl)(void *)) : limit(limit), destroy(destroy), toImpl(toImpl)
+            {
+            }
+
+            ~Pool()
+            {
+                clear();
+            }
+
+            // destroy the idle instances.
+            void clear()
+            {
+                std::vector<void *> idle;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    std::swap(idle, free);
+                }
+                for (void *ptr : idle)
+                {
+                    destroy(ptr);
+                }
+            }
+
+            void *acquire()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (free.empty())
+                {
+                    stats.misses++;
+                    return nullptr;
+                }
+                stats.hits++;
+                void *ptr = free.back();
+                free.pop_back();
+                return ptr;
+            }
+
+            void release(void *ptr)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (free.size() < limit)
+                    {
+                        stats.releases++;
+                        free.push_back(ptr);
+                        return;
+                    }
+                    stats.drops++;
+                }
+                destroy(ptr);
+            }
+
+            PoolStats getStats()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                PoolStats ret = stats;
+                ret.idle = free.size();
+                return ret;
+            }
+        };
+
+        /**
+         * Per injector state of a impl type, allocated and owned by the injector the component is
+         * bound to, so that two injectors never share a singleton, and shared by all bindings of
+         * the impl in the injector, so that bindImpl<IFoo, Foo>() and bindImpl<Foo>() have one.
+         */
+        struct State
+        {
+            std::once_flag once;
+            std::atomic<void *> instance{nullptr}; // the static instance.
+            Members members;                       // config members of the component.
+            const void *owner = nullptr; // the injector(IJ) of the state, its plan is compiled against it.
+            std::once_flag planOnce;
+            InjectionPlan plan;
+            std::unique_ptr<Pool> pool; // of dynamic instances if pooled.
+            std::shared_future<void> ready; // async inits of the static instance, invalid if none.
+            std::mutex sharedMutex;
+            std::weak_ptr<void> shared; // instance owned by the shared_ptr args of constructors.
+            void (*destroy)(void *) = nullptr; // delete a impl instance.
+            std::size_t size = 0;              // of the impl type.
+            const Wiring::Entry *wired = nullptr; // generated wiring of the impl type if present.
+        };
+        State *state = nullptr; // of the injector bound to, only for component made by impl.
         Component(std::type_index typeId, Object objS, Object objD, Members mbs)
-            : typeId(typeId), objS(objS), objD(objD), members(mbs) {};
+            : typeId(typeId), objS(objS), objD(objD), implType(typeId), members(mbs) {};
+        Component(std::type_index typeId, Object objS, Object objD, Raw rawS, Raw rawD, Members mbs)
+            : typeId(typeId), objS(objS), objD(objD), rawS(rawS), rawD(rawD), implType(typeId), members(mbs) {};
 
         template <typename T>
         T *get(Usage usgR) const
@@ -319,23 +850,115 @@ namespace fog
             return *get<T>(usgR);
         }
 
-        UsageFunc getPtrFunc(Usage usgR, std::type_index tid) const
+        bool hasUsage(Usage usgR, std::type_index tid) const
         {
-            std::function<void()> f;
+            const Object &obj = (usgR & AsStatic) ? objS : objD;
+            auto it = obj.find(tid);
+            return it != obj.end() && it->second;
+        }
 
-            UsageFunc func;
-            if (usgR & AsStatic)
+        /**
+         * New instance of the main type allocated from the heap and owned by the caller, null if the
+         * component is not made by impl or T is not the main type. Its async inits are done when
+         * returned, the owner may delete it at any time.
+         */
+        template <typename T, typename IJ>
+        T *create(IJ &ij) const
+        {
+            if (!createIn || typeId != typeid(T))
             {
-                func = getPtrFuncStatic(tid);
+                return nullptr;
             }
-            else if (usgR & AsDynamic)
+            std::shared_future<void> ready;
+            T *ret = static_cast<T *>(createIn(&ij, *state, nullptr, &ready));
+            if (ready.valid())
             {
-                func = getPtrFuncDynamic(tid);
+                try
+                {
+                    ready.get();
+                }
+                catch (...)
+                {
+                    delete ret;
+                    throw;
+                }
             }
+            return ret;
+        }
 
-            if (!func)
+        /**
+         * Instance of the main type shared by all owners, created when there is no owner alive and
+         * destroyed with the last owner, null if the component is not made by impl or T is not
+         * the main type.
+         */
+        template <typename T, typename IJ>
+        std::shared_ptr<T> getShared(IJ &ij) const
+        {
+            if (!createIn || typeId != typeid(T))
             {
-                throw std::runtime_error("no ptr func found for the type and usage required.");
+                return nullptr;
+            }
+            std::lock_guard<std::mutex> lock(state->sharedMutex);
+            if (std::shared_ptr<void> alive = state->shared.lock())
+            {
+                return std::static_pointer_cast<T>(alive);
+            }
+            std::shared_ptr<T> ret(create<T>(ij));
+            state->shared = ret;
+            return ret;
+        }
+
+        /**
+         * Dynamic provider calls createIn of the requesting scope for the main type, or the typed
+         * cast func for an interface.
+         */
+        template <typename T, typename IJ>
+        Provider<T> getProvider(Usage usgR, IJ &ij) const
+        {
+            if (usgR & AsStatic)
+            {
+                return Provider<T>(get<T>(AsStatic));
+            }
+            if (createIn && typeId == typeid(T))
+            {
+                return Provider<T>([](void *ij, const void *ctx) -> T *
+                                   {
+                                       const Component *comp = static_cast<const Component *>(ctx);
+                                       return static_cast<T *>(comp->createIn(ij, *comp->state, static_cast<IJ *>(ij)->getArena(), nullptr)); },
+                                   &ij, this);
+            }
+            if (auto it = rawD.find(typeid(T)); it != rawD.end())
+            {
+                return Provider<T>([](void *, const void *ctx) -> T *
+                                   { return static_cast<T *>((*static_cast<const PtrFunc *>(ctx))()); },
+                                   &ij, &it->second);
+            }
+            if (!hasUsage(usgR, typeid(T))) // no typed func, e.g. bind by function.
+            {
+                throw std::runtime_error("no ptr func found for the type and usage required.");
+            }
+            return Provider<T>([](void *, const void *ctx) -> T *
+                               { return static_cast<const Component *>(ctx)->template get<T>(AsDynamic); },
+                               &ij, this);
+        }
+
+        UsageFunc getPtrFunc(Usage usgR, std::type_index tid) const
+        {
+            std::function<void()> f;
+
+            UsageFunc func;
+            if (usgR & AsStatic)
+            {
+                func = getPtrFuncStatic(tid);
+            }
+            else if (usgR & AsDynamic)
+            {
+                func = getPtrFuncDynamic(tid);
+            }
+
+            if (!func)
+            {
+                throw std::runtime_error("no ptr func found for the type and usage required.");
             }
             return func;
         }
@@ -386,18 +1009,19 @@ namespace fog
         // }
 
         template <typename T, typename Imp, typename Tuple, std::size_t I>
-        static void registerInterface(Object &obj, UsageFunc createAsPtr)
+        static void registerInterface(Object &obj, Raw &raw, std::function<T *()> createAsPtr)
         {
             using InterfaceType = std::tuple_element_t<I, Tuple>;
             std::type_index tid = typeid(InterfaceType);
             auto func = [createAsPtr]() -> InterfaceType *
             {
-                std::any impAny = createAsPtr();
-                T *main = std::any_cast<T *>(impAny);
+                T *main = createAsPtr();
                 return static_cast<InterfaceType *>(main); // cast to type.
             };
 
             obj.emplace(tid, func);
+            raw.emplace(tid, [func]() -> void *
+                        { return func(); });
         }
 
         /**
@@ -420,9 +1044,10 @@ namespace fog
          *
          * And analysis the template type to find any constructor, member variable to be injected.
          * Register interface type, constructor function, member inject function and init function.
-         * The injector does not manage pointer for static or dynamic instance returned by the get
-         * method of the injector, there is no way for now to clean the static instance after
-         * created.
+         * The static instance is created once per injector and impl type, thread-safely, and kept
+         * in the state owned by that injector. Static instances are destroyed by the shutdown method of the
+         * injector, in reverse order of creation, after their DESTROY method is called. Dynamic
+         * instances are owned by the caller.
          *
          *
          */
@@ -434,50 +1059,209 @@ namespace fog
             static Component doMakeByImpl(IJ &&ij, ConfigMembers<void>::Function members)
             {
 
-                using TAdtsTuple = tuplePushFront<T, AdtsTuple>::type;
-                Component::UsageFunc funcAsStatic;  // empty func default.
-                Component::UsageFunc funcAsDynamic; // empty func default.
+                using TAdtsTuple = typename tuplePushFront<T, AdtsTuple>::type;
+                std::function<T *()> funcAsStatic;  // empty func default.
+                std::function<T *()> funcAsDynamic; // empty func default.
+
+                Component::State *state = &ij.makeState(typeid(Imp));
+                state->owner = &ij;
+                state->members = members;
+                state->destroy = [](void *ptr)
+                { delete static_cast<Imp *>(ptr); };
+                state->size = sizeof(Imp);
+                state->wired = Wiring::find(typeid(Imp));
+                makeFunctionForUsage<T, Imp>(ij, state, funcAsStatic, funcAsDynamic); //
+
+                Component comp = Component::make<T, Imp, TAdtsTuple>(funcAsStatic, funcAsDynamic,                                             //
+                                                                     std::make_index_sequence<std::tuple_size_v<std::decay_t<TAdtsTuple>>>{}, //
+                                                                     members);
+                comp.singleton = true;
+                comp.dependencies = constructorDependencies<Imp>();
+                comp.createIn = [](void *ij, Component::State &state, Arena *arena, std::shared_future<void> *ready) -> void *
+                {
+                    return static_cast<T *>(getPtrDynamic<Imp>(*static_cast<std::remove_reference_t<IJ> *>(ij), state, arena, ready));
+                };
+                comp.state = state;
+                comp.implType = typeid(Imp);
+                comp.objectInfo = &AutoRegisteredObjects::find<Imp>;
+                return comp;
+            }
 
-                makeFunctionForUsage<T, Imp>(ij, funcAsStatic, funcAsDynamic); //
+            template <typename Imp>
+            static std::vector<Component::Dependency> constructorDependencies()
+            {
+                if constexpr (hasInject<Imp>::value)
+                {
+                    using ArgsTuple = typename ConstructorTraits<std::add_pointer_t<typename Imp::Inject>>::ArgsTuple;
+                    constexpr int N = ConstructorTraits<std::add_pointer_t<typename Imp::Inject>>::arity;
+                    return constructorDependencies<Imp, ArgsTuple>(std::make_index_sequence<N>{});
+                }
+                else
+                {
+                    return {};
+                }
+            }
 
-                return Component::make<T, Imp, TAdtsTuple>(funcAsStatic, funcAsDynamic,                                             //
-                                                           std::make_index_sequence<std::tuple_size_v<std::decay_t<TAdtsTuple>>>{}, //
-                                                           members);
+            template <typename C, typename ArgsTuple, std::size_t... Is>
+            static std::vector<Component::Dependency> constructorDependencies(std::index_sequence<Is...>)
+            {
+                return {Component::Dependency{typeid(typename InjectedArg<std::tuple_element_t<Is, ArgsTuple>>::Type),
+                                              typeid(ArgOfConstructor<typename InjectedArg<std::tuple_element_t<Is, ArgsTuple>>::Type, C>),
+                                              InjectedArg<std::tuple_element_t<Is, ArgsTuple>>::eager,
+                                              InjectedArg<std::tuple_element_t<Is, ArgsTuple>>::kind}...};
             }
 
             template <typename T, typename Imp, typename IJ>
-            static void makeFunctionForUsage(IJ &&ij, Component::UsageFunc &funcAsStatic, Component::UsageFunc &funcAsDynamic)
+            static void makeFunctionForUsage(IJ &&ij, Component::State *state, std::function<T *()> &funcAsStatic, std::function<T *()> &funcAsDynamic)
             {
 
-                funcAsStatic = [&ij]() -> std::any
+                funcAsStatic = [&ij, state]() -> T *
                 {
-                    return std::make_any<T *>(getPtrStatic<Imp>(ij));
+                    return getPtrStatic<Imp>(ij, *state);
                 };
 
-                funcAsDynamic = [&ij]() -> std::any
+                funcAsDynamic = [&ij, state]() -> T *
                 {
-                    return std::make_any<T *>(getPtrDynamic<Imp>(ij));
+                    return getPtrDynamic<Imp>(ij, *state, ij.getArena());
                 };
             }
 
             template <typename T, typename IJ>
-            static T *getPtrStatic(IJ &&ij)
+            static T *getPtrStatic(IJ &&ij, Component::State &state)
             {
-                static T *instance = createInstance<T>(ij);
-                return (instance);
+                if (void *ptr = state.instance.load(std::memory_order_acquire))
+                {
+                    return static_cast<T *>(ptr);
+                }
+                if (ij.isShutDown())
+                {
+                    throw std::runtime_error("injector is shut down, cannot get the static instance.");
+                }
+                Creating creating(state, typeid(T)); // throws if it's a dependency cycle.
+                std::call_once(state.once, [&ij, &state]()
+                               {
+                                   T *ptr = createInstance<T>(ij, state, ij.getArena());
+                                   state.ready = callRegistedAsyncInit(ij, ptr, state.plan);
+                                   state.instance.store(ptr, std::memory_order_release);
+                                   ij.onCreated(state); });
+                if (void *ptr = state.instance.load(std::memory_order_acquire))
+                {
+                    return static_cast<T *>(ptr);
+                }
+                throw std::runtime_error("injector is shut down, cannot get the static instance.");
             }
 
+            /**
+             * Call the destroy methods of the static instance and delete it, the memory is left to
+             * the arena if allocated from it.
+             */
+            static void destroyStatic(Component::State &state, bool inArena)
+            {
+                void *ptr = state.instance.exchange(nullptr, std::memory_order_acq_rel);
+                if (!ptr)
+                {
+                    return;
+                }
+                std::exception_ptr error;
+                try
+                {
+                    for (const auto &destroy : state.plan.destroys)
+                    {
+                        destroy(ptr);
+                    }
+                }
+                catch (...)
+                {
+                    error = std::current_exception(); // deleted anyway.
+                }
+                if (!inArena)
+                {
+                    state.destroy(ptr);
+                }
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+
+            /**
+             * Static instances being created by the current thread, used to report a dependency
+             * cycle with the full path instead of re-entering the once-flag of the component.
+             */
+            struct Creating
+            {
+                Creating(const Component::State &state, std::type_index tid)
+                {
+                    std::vector<std::pair<const Component::State *, std::type_index>> &stack = getStack();
+                    for (std::size_t i = 0; i < stack.size(); i++)
+                    {
+                        if (stack[i].first == &state)
+                        {
+                            std::string path;
+                            for (std::size_t j = i; j < stack.size(); j++)
+                            {
+                                path += TypeIds::nameOf(stack[j].second) + " -> ";
+                            }
+                            throw std::runtime_error("dependency cycle detected: " + path + TypeIds::nameOf(tid));
+                        }
+                    }
+                    stack.emplace_back(&state, tid);
+                }
+                ~Creating()
+                {
+                    getStack().pop_back();
+                }
+
+                static std::vector<std::pair<const Component::State *, std::type_index>> &getStack()
+                {
+                    thread_local std::vector<std::pair<const Component::State *, std::type_index>> stack;
+                    return stack;
+                }
+            };
+
             template <typename T, typename IJ>
-            static T *getPtrDynamic(IJ &&ij)
+            static T *getPtrDynamic(IJ &&ij, Component::State &state, Arena *arena, std::shared_future<void> *ready = nullptr)
             {
+                if (Component::Pool *pool = state.pool.get())
+                {
+                    if (void *ptr = pool->acquire())
+                    {
+                        callRegistedReset(ptr, planOf<T>(ij, state)); // instead of injecting again.
+                        return static_cast<T *>(ptr);
+                    }
+                    arena = nullptr; // owned by the pool.
+                }
 
-                T *ptr = createInstance<T>(ij);
+                T *ptr = createInstance<T>(ij, state, arena);
+                std::shared_future<void> async = callRegistedAsyncInit(ij, ptr, planOf<T>(ij, state));
+                if (ready)
+                {
+                    *ready = async; // otherwise waited by the barrier of injector only.
+                }
                 return ptr;
             }
 
+            // from the arena if any, or the heap.
+            template <typename T, typename... Args>
+            static T *construct(Arena *arena, Args &&...args)
+            {
+                if (arena)
+                {
+                    return arena->make<T>(std::forward<Args>(args)...);
+                }
+                if constexpr (sizeof...(Args) == 0)
+                {
+                    return new T{};
+                }
+                else
+                {
+                    return new T(std::forward<Args>(args)...);
+                }
+            }
+
             // abstract as Pointer.
             template <typename T, typename IJ>
-            static typename std::enable_if_t<std::is_abstract_v<T>, T *> createInstance(IJ &&ij)
+            static typename std::enable_if_t<std::is_abstract_v<T>, T *> createInstance(IJ &&ij, Component::State &state, Arena *arena)
             {
                 static_assert(always_false<T>::value, "abstract type & no injected impl class registered.");
             }
@@ -490,106 +1274,395 @@ namespace fog
 
             // concrete && !hasInject && as Pointer
             template <typename T, typename IJ>
-            static typename std::enable_if_t<!std::is_abstract_v<T> && !hasInject<T>::value, T *> createInstance(IJ &&ij)
+            static typename std::enable_if_t<!std::is_abstract_v<T> && !hasInject<T>::value, T *> createInstance(IJ &&ij, Component::State &state, Arena *arena)
             {
-                T *ret = new T{};
-                init(ret, ij);
+                FOG_TRACE("create", typeid(T));
+                if (state.wired && state.wired->create)
+                {
+                    return createWired<T>(ij, state, arena);
+                }
+                T *ret = construct<T>(arena);
+                init(ret, ij, state);
                 return ret;
             }
 
             // concrete && hasInject && as Pointer
             template <typename T, typename IJ>
-            static typename std::enable_if_t<!std::is_abstract_v<T> && hasInject<T>::value, T *> createInstance(IJ &&ij)
+            static typename std::enable_if_t<!std::is_abstract_v<T> && hasInject<T>::value, T *> createInstance(IJ &&ij, Component::State &state, Arena *arena)
             {
-
+                FOG_TRACE("create", typeid(T));
+                if (state.wired && state.wired->create)
+                {
+                    return createWired<T>(ij, state, arena);
+                }
                 using ArgsTuple = typename ConstructorTraits<std::add_pointer_t<typename T::Inject>>::ArgsTuple;
                 constexpr int N = ConstructorTraits<std::add_pointer_t<typename T::Inject>>::arity;
-                return createInstanceByConstructor<T, ArgsTuple>(ij, std::make_index_sequence<N>{});
+                return createInstanceByConstructor<T, ArgsTuple>(ij, state, arena, std::make_index_sequence<N>{});
 
                 // static_assert(N < 2, "todo more than 1 element in args list.");
             }
 
             // C<1>:As Pointer
             template <typename T, typename ArgsTuple, typename IJ, std::size_t... Is>
-            static T *createInstanceByConstructor(IJ &&ij, std::index_sequence<Is...>)
+            static T *createInstanceByConstructor(IJ &&ij, Component::State &state, Arena *arena, std::index_sequence<Is...>)
             {
                 // usgR is the runtime arg provided by the top most getPtr(usgR), this argument control only the outer most object creation.
                 // do dynamic usge, do not propagate to deep layer, may be useful for other usage after unset the AsDynamic mask.
                 //
-                T *ret = new T(getAsConstructorArg<T, Is, std::tuple_element_t<Is, ArgsTuple>>(ij)...);
-                init<T>(ret, ij);
+                FOG_TRACE("construct", typeid(T));
+                T *ret = construct<T>(arena, getAsConstructorArg<T, Is, std::tuple_element_t<Is, ArgsTuple>>(ij)...);
+                init<T>(ret, ij, state);
+                return ret;
+            }
+
+            // by the generated constructor call.
+            template <typename T, typename IJ>
+            static T *createWired(IJ &&ij, Component::State &state, Arena *arena)
+            {
+                FOG_TRACE("construct", typeid(T));
+                T *ret = static_cast<T *>(state.wired->create(*ij.injector, arena));
+                init<T>(ret, ij, state);
                 return ret;
             }
 
+            /**
+             * Construct n instances of T into mem, constructor arguments are resolved only once
+             * for all of them, members are injected by the plan, on threads if more than 1.
+             */
             template <typename T, typename IJ>
-            static void init(T *ptr, IJ &&ij)
+            static void createMany(IJ &&ij, Component::State &state, T *mem, std::size_t n, std::size_t threads)
             {
+                const Component::InjectionPlan &plan = planOf<T>(ij, state);
+                if constexpr (hasInject<T>::value)
+                {
+                    using ArgsTuple = typename ConstructorTraits<std::add_pointer_t<typename T::Inject>>::ArgsTuple;
+                    constexpr int N = ConstructorTraits<std::add_pointer_t<typename T::Inject>>::arity;
+                    createManyByConstructor<T, ArgsTuple>(ij, state, plan, mem, n, threads, std::make_index_sequence<N>{});
+                }
+                else
+                {
+                    constructMany(ij, state, plan, mem, n, threads, [](T *ptr)
+                                  { new (ptr) T{}; });
+                }
+                if (!plan.asyncInits.empty())
+                {
+                    waitAsyncInits(ij, plan, mem, n);
+                }
+            }
 
-                AutoRegisteredObjects &autoRegObjs = AutoRegisteredObjects::getInstance();
-                if (auto itObj = autoRegObjs.objects.find(std::type_index(typeid(T))); itObj != autoRegObjs.objects.end()) // make init func to setting fields.
+            // the instances must outlive their async inits, all of them are destroyed if any failed.
+            template <typename T, typename IJ>
+            static void waitAsyncInits(IJ &&ij, const Component::InjectionPlan &plan, T *mem, std::size_t n)
+            {
+                std::vector<std::shared_future<void>> asyncs;
+                asyncs.reserve(n);
+                for (std::size_t i = 0; i < n; i++)
+                {
+                    asyncs.push_back(callRegistedAsyncInit(ij, mem + i, plan));
+                }
+                std::exception_ptr error;
+                for (std::shared_future<void> &async : asyncs)
                 {
-                    std::any objPA = std::make_any<T *>(ptr);
-                    const AutoRegisteredObjects::ObjectInfo &objInfo = itObj->second;
-                    setRegistedMembers<T>(objPA, objInfo, ij);
-                    callRegistedInit<T>(objPA, objInfo);
+                    try
+                    {
+                        async.get();
+                    }
+                    catch (...)
+                    {
+                        error = error ? error : std::current_exception();
+                    }
+                }
+                if (error)
+                {
+                    for (std::size_t i = 0; i < n; i++)
+                    {
+                        mem[i].~T();
+                    }
+                    std::rethrow_exception(error);
                 }
             }
 
-            template <typename T>
-            static void callRegistedInit(std::any &objPA, const AutoRegisteredObjects::ObjectInfo &objInfo)
+            template <typename T, typename ArgsTuple, typename IJ, std::size_t... Is>
+            static void createManyByConstructor(IJ &&ij, Component::State &state, const Component::InjectionPlan &plan, T *mem, std::size_t n, std::size_t threads, std::index_sequence<Is...>)
             {
-                for (const auto &init : objInfo.inits)
+                // resolved once and shared by all instances, except fresh args which are resolved for each.
+                std::tuple<decltype(getAsSharedArg<T, Is, std::tuple_element_t<Is, ArgsTuple>>(ij))...> args(
+                    getAsSharedArg<T, Is, std::tuple_element_t<Is, ArgsTuple>>(ij)...);
+                constructMany(ij, state, plan, mem, n, threads, [&ij, &args](T *ptr)
+                              { new (ptr) T(getAsArgOfMany<T, Is, std::tuple_element_t<Is, ArgsTuple>>(ij, std::get<Is>(args))...); });
+            }
+
+            template <typename C, std::size_t I, typename Arg, typename IJ>
+            static decltype(auto) getAsSharedArg(IJ &&ij)
+            {
+                if constexpr (InjectedArg<Arg>::fresh)
+                {
+                    return nullptr;
+                }
+                else
+                {
+                    return getAsConstructorArg<C, I, Arg>(ij);
+                }
+            }
+
+            template <typename C, std::size_t I, typename Arg, typename IJ, typename V>
+            static decltype(auto) getAsArgOfMany(IJ &&ij, V &shared)
+            {
+                if constexpr (InjectedArg<Arg>::fresh)
                 {
-                    init.method(objPA);
+                    return getAsConstructorArg<C, I, Arg>(ij);
+                }
+                else
+                {
+                    return static_cast<V &>(shared);
+                }
+            }
+
+            template <typename T, typename IJ, typename F>
+            static void constructMany(IJ &&ij, Component::State &state, const Component::InjectionPlan &plan, T *mem, std::size_t n, std::size_t threads, F &&construct)
+            {
+                threads = std::max<std::size_t>(1, std::min(threads, n));
+                std::size_t chunk = (n + threads - 1) / threads;
+                std::vector<std::size_t> built(threads, 0);
+                std::mutex mutex;
+                std::exception_ptr error;
+                auto run = [&](std::size_t c)
+                {
+                    try
+                    {
+                        for (std::size_t i = c * chunk; i < std::min(n, (c + 1) * chunk); i++)
+                        {
+                            construct(mem + i);
+                            built[c]++;
+                            inject(mem + i, ij, state, plan);
+                        }
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        error = error ? error : std::current_exception();
+                    }
+                };
+                if (threads == 1)
+                {
+                    run(0);
+                }
+                else
+                {
+                    WorkerPool pool(threads);
+                    for (std::size_t c = 0; c < threads; c++)
+                    {
+                        pool.submit([&run, c]()
+                                    { run(c); });
+                    }
+                    pool.wait();
+                }
+                if (error)
+                {
+                    for (std::size_t c = 0; c < threads; c++)
+                    {
+                        for (std::size_t i = c * chunk; i < c * chunk + built[c]; i++)
+                        {
+                            mem[i].~T();
+                        }
+                    }
+                    std::rethrow_exception(error);
                 }
             }
+
             template <typename T, typename IJ>
-            static void setRegistedMembers(std::any &objPA, const AutoRegisteredObjects::ObjectInfo &objInfo, IJ &&ij)
+            static void init(T *ptr, IJ &&ij, Component::State &state)
             {
-                //
+                inject(ptr, ij, state, planOf<T>(ij, state));
+            }
 
+            /**
+             * Plan of T compiled against the requesting scope: the one kept in the state for the
+             * injector the state belongs to, or one kept by the child scope for a component bound
+             * to its parent, so that its members resolve the bindings of the child.
+             */
+            template <typename T, typename IJ>
+            static const Component::InjectionPlan &planOf(IJ &&ij, Component::State &state)
+            {
+                if (state.owner == &ij)
+                {
+                    std::call_once(state.planOnce, [&ij, &state]()
+                                   { compilePlan<T>(ij, state.members, state.wired, state.plan); });
+                    return state.plan;
+                }
+                return ij.scopedPlan(state, [&ij, &state](Component::InjectionPlan &plan)
+                                     { compilePlan<T>(ij, state.members, state.wired, plan); });
+            }
+
+            // members and inits by the plan, and by the generated wiring if present.
+            template <typename IJ>
+            static void inject(void *ptr, IJ &&ij, const Component::State &state, const Component::InjectionPlan &plan)
+            {
+                setRegistedMembers(ptr, plan);
+                if (state.wired && state.wired->inject)
+                {
+                    state.wired->inject(ptr, *ij.injector);
+                }
+                callRegistedInit(ptr, plan);
+            }
+
+            static void callRegistedInit(void *obj, const Component::InjectionPlan &plan)
+            {
+                if (plan.inits.empty())
+                {
+                    return;
+                }
+                FOG_TRACE("init", *plan.type);
+                for (const auto &init : plan.inits)
+                {
+                    init(obj);
+                }
+            }
+
+            template <typename IJ>
+            static std::shared_future<void> callRegistedAsyncInit(IJ &&ij, void *obj, const Component::InjectionPlan &plan)
+            {
+                if (plan.asyncInits.empty())
+                {
+                    return {};
+                }
+                const Component::InjectionPlan *planPtr = &plan;
+                return ij.runAsync([obj, planPtr]()
+                                   {
+                                       FOG_TRACE("init_async", *planPtr->type);
+                                       for (const auto &init : planPtr->asyncInits)
+                                       {
+                                           init(obj);
+                                       } });
+            }
+
+            static void callRegistedReset(void *obj, const Component::InjectionPlan &plan)
+            {
+                for (const auto &reset : plan.resets)
+                {
+                    reset(obj);
+                }
+            }
+
+            static void setRegistedMembers(void *obj, const Component::InjectionPlan &plan)
+            {
+                if (plan.steps.empty())
+                {
+                    return;
+                }
+                FOG_TRACE("members", *plan.type);
+                for (const Component::InjectionPlan::Step &step : plan.steps)
+                {
+                    if (step.source)
+                    {
+                        step.member->assign(obj, step.source());
+                    }
+                    else if (const Options::Option *opt = step.config.option())
+                    {
+                        step.member->assign(obj, const_cast<void *>(opt->data()));
+                    }
+                    else if (step.src)
+                    {
+                        step.member->assign(obj, step.src);
+                    }
+                    else
+                    {
+                        throw std::runtime_error("connot resolve the value for member:" + step.config.name + "(no option and no default value)");
+                    }
+                }
+            }
+
+            /**
+             * Resolve the source of every registered member of T once: the bound component of
+             * the member type, or the value from config members, or the default value.
+             */
+            template <typename T, typename IJ>
+            static void compilePlan(IJ &&ij, const Members &members, const Wiring::Entry *wired, Component::InjectionPlan &plan)
+            {
+                const AutoRegisteredObjects::ObjectInfo *objPtr = AutoRegisteredObjects::find<T>();
+                if (!objPtr) // no member or init registered.
+                {
+                    return;
+                }
+                const AutoRegisteredObjects::ObjectInfo &objInfo = *objPtr;
+                Component::InjectionPlan compiled;
+                compiled.type = &typeid(T);
                 for (const auto &fieldPair : objInfo.members)
                 {
                     const std::string &mebName = fieldPair.first;
                     const AutoRegisteredObjects::MemberInfo &mebInfo = fieldPair.second;
+                    if (wired && std::find(wired->members.begin(), wired->members.end(), mebName) != wired->members.end())
+                    {
+                        continue; // assigned by the generated wiring.
+                    }
                     //
-
-                    std::any val;
+                    Component::InjectionPlan::Step step{};
+                    step.member = &mebInfo;
                     const Component *cPtr = ij(mebInfo.vType);
-                    if (cPtr)
+                    if (mebInfo.makeLazy)
+                    {
+                        const Component *lPtr = ij(mebInfo.lazyType);
+                        if (!lPtr)
+                        {
+                            throw std::runtime_error("connot resolve the component for lazy member:" + mebName);
+                        }
+                        std::type_index lType = mebInfo.lazyType;
+                        step.value = mebInfo.makeLazy([lPtr, lType]()
+                                                      { return lPtr->get(Component::AsStatic, lType); }); // shared by all instances.
+                    }
+                    else if (cPtr)
                     {
-                        if (mebInfo.asPtr)
+                        if (auto it = cPtr->rawS.find(mebInfo.vType); it != cPtr->rawS.end())
                         {
-                            val = cPtr->get(Component::AsStatic, mebInfo.vType);
+                            step.source = it->second;
                         }
                         else
                         {
-                            val = cPtr->get(Component::AsStatic, mebInfo.vType); // TODO
+                            step.source = [cPtr, &mebInfo]() -> void *
+                            {
+                                return mebInfo.ptrOf(cPtr->get(Component::AsStatic, mebInfo.vType));
+                            };
                         }
                         //
                     }
                     else
-                    { // no component bind to the type, try to get registed fields.
-                        const Component *pCPtr = ij(typeid(T));
-                        if (pCPtr->members)
-                        {
-                            if (!(pCPtr->members)(mebInfo.vType, mebName, mebInfo.key, val, false))
-                            {
-                                if (!(mebInfo.defaultVal)(val))
-                                {
-                                    throw std::runtime_error("connot resolve the value for member:" + mebName + ",key:" + mebInfo.key + "(no default value)");
-                                }
-                            }
-                        }
-                        else
+                    { // no component bind to the type, try to get registed fields, then the default value.
+                        bool found = members && members(mebInfo.vType, mebName, mebInfo.key, step.config, false);
+                        if (!(mebInfo.defaultVal)(step.value) && !found)
                         {
-                            throw std::runtime_error("connot resolve the value for member:" + mebName + ",key:" + mebInfo.key + "(no function registered)");
+                            throw std::runtime_error("connot resolve the value for member:" + mebName + ",key:" + mebInfo.key + (members ? "(no default value)" : "(no function registered)"));
                         }
                     }
-
-                    (mebInfo.setter)(objPA, val);
+                    compiled.steps.push_back(std::move(step));
 
                 } // fields
+                for (Component::InjectionPlan::Step &step : compiled.steps)
+                {
+                    if (!step.source && step.value.has_value())
+                    {
+                        step.src = step.member->srcOf(step.value); // the values do not move any more.
+                    }
+                }
+                for (const auto &init : objInfo.inits)
+                {
+                    if (!(wired && wired->init))
+                    {
+                        compiled.inits.push_back(init.invoke);
+                    }
+                }
+                for (const auto &reset : objInfo.resets)
+                {
+                    compiled.resets.push_back(reset.invoke);
+                }
+                for (const auto &init : objInfo.asyncInits)
+                {
+                    compiled.asyncInits.push_back(init.invoke);
+                }
+                for (const auto &destroy : objInfo.destroys)
+                {
+                    compiled.destroys.push_back(destroy.invoke);
+                }
+                plan = std::move(compiled);
             }
 
             // Arg as Pointer
@@ -609,23 +1682,102 @@ namespace fog
                 return *ret;
             }
 
+            // Arg as Provider, instances from the pool of a pooled binding, otherwise the static instance.
+            template <typename C, std::size_t I, typename Arg, typename IJ>
+            static typename std::enable_if_t<isProvider<Arg>::value, Arg> getAsConstructorArg(IJ &&ij)
+            {
+                using T = std::remove_pointer_t<decltype(std::declval<Arg>().get())>;
+                const Component *cPtr = ij.template find<T>();
+                if (!cPtr)
+                {
+                    throw std::runtime_error("cannot resolve component for a provider arg of constructor.");
+                }
+                if (cPtr->state && cPtr->state->pool && cPtr->createIn)
+                {
+                    return cPtr->getProvider<T>(Component::AsDynamic, ij);
+                }
+                return Arg(ij.template getStatic<T>());
+            }
+
+            // Arg as Lazy, nothing created until dereference.
+            template <typename C, std::size_t I, typename Arg, typename IJ>
+            static typename std::enable_if_t<isLazy<Arg>::value, Arg> getAsConstructorArg(IJ &&ij)
+            {
+                using T = typename isLazy<Arg>::Type;
+                if (!ij.template find<T>())
+                {
+                    throw std::runtime_error("cannot resolve component for a lazy arg of constructor.");
+                }
+                return Arg([&ij]()
+                           { return ij.template getStatic<T>(); });
+            }
+
+            // Arg as unique_ptr, a new instance owned by the constructor, its async inits done.
             template <typename C, std::size_t I, typename Arg, typename IJ>
-            static typename std::enable_if_t<!std::is_pointer_v<Arg> && !std::is_reference_v<Arg>, Arg &> getAsConstructorArg(IJ &&ij) // return Arg or Arg *
+            static typename std::enable_if_t<isUniquePtr<Arg>::value, Arg> getAsConstructorArg(IJ &&ij)
             {
+                using T = typename Arg::element_type;
+                const Component *cPtr = ij.template find<T>();
+                T *ptr = cPtr ? cPtr->create<T>(ij) : nullptr;
+                if (!ptr)
+                {
+                    throw std::runtime_error("cannot resolve component for a unique_ptr arg of constructor(not bound by impl).");
+                }
+                return Arg(ptr);
+            }
+
+            // Arg as shared_ptr, the instance shared by all shared_ptr args, or the static instance not owned if not bound by impl.
+            template <typename C, std::size_t I, typename Arg, typename IJ>
+            static typename std::enable_if_t<isSharedPtr<Arg>::value, Arg> getAsConstructorArg(IJ &&ij)
+            {
+                using T = typename Arg::element_type;
+                const Component *cPtr = ij.template find<T>();
+                if (!cPtr)
+                {
+                    throw std::runtime_error("cannot resolve component for a shared_ptr arg of constructor.");
+                }
+                if (Arg ret = cPtr->getShared<T>(ij))
+                {
+                    return ret;
+                }
+                return Arg(Arg(), ij.template getStatic<T>());
+            }
+
+            // Arg as value, a new instance moved in if the component is bound by impl of the same type, otherwise a copy.
+            template <typename C, std::size_t I, typename Arg, typename IJ>
+            static typename std::enable_if_t<!std::is_pointer_v<Arg> && !std::is_reference_v<Arg> && !isProvider<Arg>::value && !isLazy<Arg>::value && //
+                                                 !isUniquePtr<Arg>::value && !isSharedPtr<Arg>::value,
+                                             Arg>
+            getAsConstructorArg(IJ &&ij)
+            {
+                const Component *cPtr = ij.template find<Arg>();
+                if (cPtr && cPtr->implType == typeid(Arg) && !hasAsyncInit(*cPtr))
+                {
+                    if (std::unique_ptr<Arg> fresh{cPtr->create<Arg>(ij)})
+                    {
+                        return std::move(*fresh);
+                    }
+                }
                 Arg *ret = doGetAsConstructorArg<C, I, Arg>(ij);
                 return *ret;
             }
 
+            // the instance cannot be moved from while the async inits are running.
+            static bool hasAsyncInit(const Component &comp)
+            {
+                const AutoRegisteredObjects::ObjectInfo *objInfo = comp.objectInfo ? comp.objectInfo() : nullptr;
+                return objInfo && !objInfo->asyncInits.empty();
+            }
+
             template <typename C, std::size_t I, typename T, typename IJ>
             static T *doGetAsConstructorArg(IJ &&ij)
             {
-                const Component *cPtr = (ij)(typeid(T));
-                if (cPtr)
+                if (ij.template find<T>())
                 {
-                    return cPtr->get<T>(Component::AsStatic);
+                    return ij.template getStatic<T>();
                 }
 
-                cPtr = ij(typeid(ArgOfConstructor<T, C>));
+                const Component *cPtr = ij(typeid(ArgOfConstructor<T, C>));
                 if (cPtr)
                 {
                     ArgOfConstructor<T, C> *cArg = cPtr->get<ArgOfConstructor<T, C>>(Component::AsStatic);
@@ -12,16 +12,47 @@ namespace fog
     struct hasGroup<T, std::void_t<decltype(T::Group)>> : std::true_type
     {
     };
+    /**
+     * Option of a config member resolved to its group once, the option itself is looked up by
+     * the key(hashed once) when read, so it follows options set or replaced afterwards. It refers
+     * to the options of the group, the group must not be erased from the groups while it's used.
+     */
+    struct ConfigSource
+    {
+        const Options *group = nullptr; // null if not resolved.
+        std::string name;
+        std::size_t hash = 0;
+        std::type_index type = typeid(void);
+
+        ConfigSource() = default;
+
+        ConfigSource(const Options &group, Options::Key key, std::type_index type) : group(&group), name(key.name), hash(key.hash), type(type)
+        {
+        }
+
+        // null if the option does not exist.
+        const Options::Option *option() const
+        {
+            const Options::Option *opt = group ? group->getOption(Options::Key(name, hash)) : nullptr;
+            if (opt && opt->getType() != type)
+            {
+                throw std::runtime_error("cannot resolve option " + name + "(type mismatch)");
+            }
+            return opt;
+        }
+    };
+
     template <typename T>
     struct ConfigMembers
     {
-        using Function = std::function<bool(const std::type_index &, const std::string &, const std::string &, std::any &, bool strict)>;
+        using Function = std::function<bool(const std::type_index &, std::string_view, std::string_view, ConfigSource &, bool strict)>;
 
         ConfigMembers(std::function<Options::Groups *()> groups) : groups(groups)
         {
         }
 
-        bool operator()(const std::type_index &mType, const std::string &mName, const std::string &key, std::any &fval, bool strict)
+        // the source is resolved if the group exists, returns if the option exists too.
+        bool operator()(const std::type_index &mType, std::string_view mName, std::string_view key, ConfigSource &src, bool strict)
         {
             Options::Groups *gps = groups();
             if (!gps)
@@ -32,45 +63,51 @@ namespace fog
                 }
                 return false;
             }
-            std::string rKey = key.empty() ? mName : key;
-            std::string gname = resolveGroup<T>();
+            Options::Key rKey = key.empty() ? mName : key;
+            const std::string &gname = resolveGroup<T>();
             if (auto it = gps->groups.find(gname); it != gps->groups.end())
             {
-                Options &ops = it->second;
-
-                Options::Option *opt = ops.getOption(rKey);
-                if (opt)
+                src = ConfigSource(it->second, rKey, mType);
+                if (src.option())
                 {
-                    if(opt->getType() != mType){
-                        throw std::runtime_error("cannot resolve option[" + gname + "]" + rKey + "(type mismatch)");
-                    }
-                    fval = opt->getValue();
                     return true;
                 }
                 if (strict)
                 {
 
-                    throw std::runtime_error("cannot resolve option [" + gname + "]" + rKey + "(no option found)");
+                    throw std::runtime_error("cannot resolve option [" + gname + "]" + std::string(rKey.name) + "(no option found)");
                 }
+                return false;
             }
             if (strict)
             {
-                throw std::runtime_error("cannot resolve option [" + gname + "]" + rKey + "(no group found)");
+                throw std::runtime_error("cannot resolve option [" + gname + "]" + std::string(rKey.name) + "(no group found)");
             }
             return false;
         }
 
+        bool operator()(const std::type_index &mType, std::string_view mName, std::string_view key, std::any &fval, bool strict)
+        {
+            ConfigSource src;
+            if (!(*this)(mType, mName, key, src, strict))
+            {
+                return false;
+            }
+            fval = src.option()->getValue();
+            return true;
+        }
+
     private:
         std::function<Options::Groups *()> groups;
 
         template <typename X>
-        static std::enable_if_t<hasGroup<X>::value, std::string> resolveGroup()
+        static std::enable_if_t<hasGroup<X>::value, const std::string &> resolveGroup()
         {
             return X::Group;
         }
 
         template <typename X>
-        static std::enable_if_t<!hasGroup<X>::value, std::string> resolveGroup()
+        static std::enable_if_t<!hasGroup<X>::value, const std::string &> resolveGroup()
         {
             throw std::runtime_error("cannot resolve group without X::Group");
         }
@@ -4,20 +4,225 @@
  */
 #pragma once
 #include "Component.h"
+#include "TypeIds.h"
+#include "WorkerPool.h"
+#include "Batch.h"
+#include <chrono>
+#include <ostream>
 
 namespace fog
 {
     struct Injector
     {
+        /**
+         * Result of warm up, the construction time of each component does not include the time of
+         * its dependencies, which are always created before.
+         */
+        struct WarmUpReport
+        {
+            struct Entry
+            {
+                std::type_index type;
+                std::chrono::nanoseconds time;
+                std::thread::id thread;
+            };
+            std::vector<Entry> entries; // in order of completion.
+            std::chrono::nanoseconds total{0};
+
+            std::string toString() const
+            {
+                std::string ret = fmt::format("warm up {} components in {}us\n", entries.size(), total.count() / 1000);
+                for (const Entry &entry : entries)
+                {
+                    ret += fmt::format("  {}us\t{}\n", entry.time.count() / 1000, TypeIds::nameOf(entry.type));
+                }
+                return ret;
+            }
+        };
+
+        /**
+         * Objects alive in the injector: the static instances not destroyed yet, the idle
+         * instances of pools and the objects in the arena of a child scope.
+         */
+        struct LiveStats
+        {
+            std::size_t objects = 0;
+            std::size_t bytes = 0;
+        };
+
         Injector()
         {
+            ij.injector = this;
         }
 
+        /**
+         * Child scope of the parent injector, the bindings of the parent are inherited and its
+         * singletons are shared, while components bound to this scope can see the bindings of
+         * both. Dynamic instances created through this scope, and the singletons of the components
+         * bound to it, are allocated from the arena of this scope and are all destroyed and
+         * released in one shot when the scope is destroyed. A dynamic instance of a component
+         * bound to the parent resolves its arguments and members against this scope, the
+         * singletons of the parent against the parent. The parent must outlive the scope.
+         */
+        explicit Injector(Injector *parent)
+        {
+            ij.injector = this;
+            ij.parent = &parent->ij;
+            ij.arena = std::make_unique<Arena>();
+        }
+
+        /**
+         * Shuts down if not done yet, a failure of a DESTROY method is dropped here, call
+         * shutdown() before to get it.
+         */
+        ~Injector()
+        {
+            try
+            {
+                ij.shutdown();
+            }
+            catch (...)
+            {
+            }
+        }
+
+        Injector(const Injector &) = delete;
+        Injector &operator=(const Injector &) = delete;
+
         void bindComp(Component comp)
         {
             return ij.bindComp(comp);
         }
 
+        /**
+         * End of the binding phase, any bind after this call is rejected.
+         *
+         * The component table is immutable from now on, so get<T>() can be called from any thread
+         * without external locking: a resolved get is a plain read of the table, the first static
+         * get of a component only waits on the once-flag of that component.
+         */
+        void freeze()
+        {
+            ij.frozen.store(true, std::memory_order_release);
+        }
+
+        bool isFrozen() const
+        {
+            return ij.frozen.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Check all bindings at once instead of failing deep inside a get.
+         *
+         * Builds the dependency graph of the components bound by impl from their INJECT
+         * constructor arguments and registered members, the exception thrown lists every missing
+         * binding, every member that cannot be resolved and every dependency cycle with its path.
+         * The creation order(dependencies first) is recorded for warmUp only, get() still creates
+         * the dependencies of a component recursively on its first call, so warm up to keep the
+         * creation off the hot path. Call it before sharing the injector between threads.
+         */
+        void validate()
+        {
+            std::vector<std::string> problems = ij.validate();
+            if (!problems.empty())
+            {
+                std::string msg = "invalid bindings:";
+                for (const std::string &problem : problems)
+                {
+                    msg += "\n  " + problem;
+                }
+                throw std::runtime_error(msg);
+            }
+        }
+
+        /**
+         * Freeze and create all static instances of the components bound by impl.
+         *
+         * The dependency graph is derived from the INJECT constructor arguments and the registered
+         * members of each component, components are created in topological order on a pool of
+         * threads(0 for hardware concurrency), so independent subtrees are created concurrently.
+         */
+        WarmUpReport warmUp(std::size_t threads = 0)
+        {
+            using Clock = std::chrono::steady_clock;
+            freeze();
+            Clock::time_point begin = Clock::now();
+            validate();
+
+            const std::vector<const Component *> &nodes = ij.graph.order;
+            std::unordered_map<const Component *, std::size_t> index;
+            for (std::size_t i = 0; i < nodes.size(); i++)
+            {
+                index.emplace(nodes[i], i);
+            }
+            std::vector<std::vector<std::size_t>> dependents(nodes.size());
+            std::vector<std::atomic<std::size_t>> waiting(nodes.size());
+            for (std::size_t i = 0; i < nodes.size(); i++)
+            {
+                for (const Component *dep : ij.graph.dependencies.at(nodes[i]))
+                {
+                    if (auto it = index.find(dep); it != index.end())
+                    {
+                        dependents[it->second].push_back(i);
+                        waiting[i]++;
+                    }
+                }
+            }
+
+            WarmUpReport report;
+            std::mutex mutex;
+            std::exception_ptr error;
+            WorkerPool pool(threads);
+            std::function<void(std::size_t)> create = [&](std::size_t i)
+            {
+                Clock::time_point start = Clock::now();
+                try
+                {
+                    ij.createStatic(*nodes[i]);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    error = error ? error : std::current_exception();
+                    return;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    report.entries.push_back({nodes[i]->typeId, Clock::now() - start, std::this_thread::get_id()});
+                }
+                for (std::size_t d : dependents[i])
+                {
+                    if (--waiting[d] == 0)
+                    {
+                        pool.submit([&create, d]()
+                                    { create(d); });
+                    }
+                }
+            };
+
+            std::vector<std::size_t> roots;
+            for (std::size_t i = 0; i < nodes.size(); i++)
+            {
+                if (waiting[i] == 0)
+                {
+                    roots.push_back(i);
+                }
+            }
+            for (std::size_t i : roots)
+            {
+                pool.submit([&create, i]()
+                            { create(i); });
+            }
+            pool.wait();
+
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+            report.total = Clock::now() - begin;
+            return report;
+        }
+
         template <typename T, typename F>
         void bindFunc(F &&ptrFunc)
         {
@@ -37,6 +242,73 @@ namespace fog
             bindComp(Component::make<T, Imp, std::tuple<>>(ij));
         }
 
+        /**
+         * Bind with pooled dynamic usage: instances passed to release() are kept in a free list
+         * of at most limit entries and handed out again by the dynamic get, re-initialized by the
+         * RESET(...) method if registered, instead of being created and injected again. Adts are
+         * the additional interfaces, as for bindImpl.
+         */
+        template <typename T, typename Imp = T, typename... Adts>
+        void bindPooled(std::size_t limit)
+        {
+            Component comp = Component::make<T, Imp, std::tuple<Adts...>>(ij);
+            comp.state->pool = std::make_unique<Component::Pool>(
+                limit,
+                [](void *ptr)
+                { delete static_cast<Imp *>(ptr); },
+                [](void *ptr) -> void *
+                { return static_cast<Imp *>(static_cast<T *>(ptr)); });
+            bindComp(comp);
+        }
+
+        template <typename T>
+        void release(T *obj)
+        {
+            getPool<T>().release(getPool<T>().toImpl(obj));
+        }
+
+        template <typename T>
+        PoolStats getPoolStats()
+        {
+            return getPool<T>().getStats();
+        }
+
+        /**
+         * Create n dynamic instances of T in one contiguous allocation, T must be bound as impl of
+         * itself, not pooled and not constructed by a generated wiring. The INJECT constructor
+         * arguments and the members are resolved once and shared by all instances, the
+         * construction is split on threads if more than 1. The INIT_ASYNC methods are waited for
+         * before returning, the first failure is rethrown.
+         */
+        template <typename T>
+        Batch<T> createMany(std::size_t n, std::size_t threads = 1)
+        {
+            const Component &comp = ij.resolve<T>();
+            if (!comp.state || comp.implType != typeid(T))
+            {
+                throw std::runtime_error("cannot create many, the type must be bound as impl of itself.");
+            }
+            if (comp.state->pool)
+            {
+                throw std::runtime_error("cannot create many, the type is pooled, get it from the pool instead.");
+            }
+            if (comp.state->wired && comp.state->wired->create)
+            {
+                throw std::runtime_error("cannot create many, the type is constructed by a generated wiring.");
+            }
+            T *mem = Batch<T>::allocate(n);
+            try
+            {
+                Component::Impl::createMany<T>(ij, *comp.state, mem, n, threads);
+            }
+            catch (...)
+            {
+                Batch<T>::deallocate(mem);
+                throw;
+            }
+            return Batch<T>(mem, n);
+        }
+
         template <typename T, typename Imp, typename T1>
         void bindImpl()
         {
@@ -87,7 +359,139 @@ namespace fog
         template <typename T, Component::Usage usgR = Component::AsStatic>
         T *get()
         {
-            return ij.getComponent(typeid(T)).get<T>(usgR);
+            if constexpr ((usgR & Component::AsStatic) != 0)
+            {
+                return ij.getStatic<T>();
+            }
+            else
+            {
+                const Component &comp = ij.resolve<T>();
+                if (comp.createIn)
+                {
+                    return static_cast<T *>(comp.createIn(&ij, *comp.state, ij.getArena(), nullptr));
+                }
+                return comp.template get<T>(usgR);
+            }
+        }
+
+        /**
+         * Static instance of T once its INIT_ASYNC method completed, the instance itself is created
+         * by the calling thread, the async init runs on the worker pool of the injector.
+         */
+        template <typename T>
+        std::shared_future<T *> getAsync()
+        {
+            T *ptr = get<T>();
+            const Component &comp = ij.resolve<T>();
+            if (!comp.state || !comp.state->ready.valid())
+            {
+                std::promise<T *> promise;
+                promise.set_value(ptr);
+                return promise.get_future().share();
+            }
+            std::shared_future<void> ready = comp.state->ready;
+            return std::async(std::launch::deferred, [ready, ptr]()
+                              {
+                                  ready.get();
+                                  return ptr; })
+                .share();
+        }
+
+        /**
+         * Barrier of all INIT_ASYNC methods started so far, the first failure is rethrown.
+         */
+        void waitReady()
+        {
+            ij.waitAsync();
+        }
+
+        /**
+         * Destroy all static instances created by this injector in reverse order of creation, so
+         * dependencies outlive their dependents. The DESTROY method of each instance is called
+         * before it's deleted, idle pooled instances are deleted and the arena of a child scope
+         * is released. Any static get afterwards throws, dynamic instances are still owned by
+         * the caller. Must not run concurrently with a get, the first failure of a DESTROY method
+         * is rethrown after all instances are destroyed. Called by the destructor if not before.
+         */
+        void shutdown()
+        {
+            ij.shutdown();
+        }
+
+        LiveStats getLiveStats()
+        {
+            return ij.getLiveStats();
+        }
+
+        /**
+         * Write the metadata of the components bound by impl for fog-wiring-gen, one record per
+         * line with tab separated fields, in order of the impl names:
+         *
+         *   component <impl> <type>
+         *   arg <kind> <type> <bound>
+         *   member <name> <type> <pointer> <bound> <lazy>
+         *   init <name>
+         *   end
+         *
+         * Call it from a small executable binding the same components as the application, see
+         * fog_generate_wiring in CMakeLists.txt.
+         */
+        void writeWiring(std::ostream &os) const
+        {
+            static const char *kinds[] = {"pointer", "reference", "value", "provider", "lazy", "unique", "shared"};
+            std::vector<const Component *> comps;
+            for (const auto &pair : ij.components)
+            {
+                if (pair.second.state)
+                {
+                    comps.push_back(&pair.second);
+                }
+            }
+            std::sort(comps.begin(), comps.end(), [](const Component *a, const Component *b)
+                      { return TypeIds::nameOf(a->implType) < TypeIds::nameOf(b->implType); });
+            for (std::size_t i = 0; i < comps.size(); i++)
+            {
+                const Component *comp = comps[i];
+                if (i > 0 && comps[i - 1]->implType == comp->implType)
+                {
+                    continue; // same impl bound to more than one type.
+                }
+                os << "component\t" << TypeIds::nameOf(comp->implType) << "\t" << TypeIds::nameOf(comp->typeId) << "\n";
+                for (const Component::Dependency &dep : comp->dependencies)
+                {
+                    os << "arg\t" << kinds[static_cast<int>(dep.kind)] << "\t" << TypeIds::nameOf(dep.type) << "\t" << (ij(dep.type) != nullptr) << "\n";
+                }
+                if (const AutoRegisteredObjects::ObjectInfo *objInfo = comp->objectInfo ? comp->objectInfo() : nullptr)
+                {
+                    for (const auto &fieldPair : objInfo->members)
+                    {
+                        const AutoRegisteredObjects::MemberInfo &mebInfo = fieldPair.second;
+                        os << "member\t" << fieldPair.first << "\t" << TypeIds::nameOf(mebInfo.vType) << "\t" << mebInfo.asPtr << "\t"
+                           << (ij(mebInfo.vType) != nullptr) << "\t" << static_cast<bool>(mebInfo.makeLazy) << "\n";
+                    }
+                    for (const AutoRegisteredObjects::MethodInfo &init : objInfo->inits)
+                    {
+                        os << "init\t" << init.name << "\n";
+                    }
+                }
+                os << "end\n";
+            }
+        }
+
+        /**
+         * Resolve the binding of T once, the returned provider does no lookup afterwards.
+         */
+        template <typename T, Component::Usage usgR = Component::AsStatic>
+        Provider<T> getProvider()
+        {
+            if constexpr ((usgR & Component::AsStatic) != 0)
+            {
+                return Provider<T>(ij.getStatic<T>());
+            }
+            else
+            {
+                return ij.resolve<T>().template getProvider<T>(usgR, ij);
+            }
         }
 
         // template <typename T>
@@ -100,18 +504,63 @@ namespace fog
         template <typename T, typename C, typename F>
         void bindArgOfConstructor(F &&func)
         {
-            bindFunc<ArgOfConstructor<T, C>>([func]() -> ArgOfConstructor<T, C> *
+            auto instance = std::make_shared<ArgOfConstructor<T, C>>(func); // owned by this injector.
+            bindFunc<ArgOfConstructor<T, C>>([instance]() -> ArgOfConstructor<T, C> *
                                              {
-                                                 static ArgOfConstructor<T, C> instance(func);
-                                                 return &instance; //
+                                                 return instance.get(); //
                                              });
         }
         //
     private:
+        template <typename T>
+        Component::Pool &getPool()
+        {
+            const Component &comp = ij.resolve<T>();
+            if (!comp.state || !comp.state->pool)
+            {
+                throw std::runtime_error("component is not bound as pooled.");
+            }
+            return *comp.state->pool;
+        }
+
     private:
         struct IJ
         {
+            /**
+             * Flat table entry indexed by the dense id of the bound type, see TypeIds.
+             * The instance is cached after the first static get of a singleton component,
+             * a resolved get is then an array index plus a pointer load.
+             */
+            struct Slot
+            {
+                const Component *comp = nullptr;
+                std::atomic<void *> instance{nullptr};
+
+                Slot() = default;
+                Slot(const Slot &slot) : comp(slot.comp), instance(slot.instance.load())
+                {
+                }
+            };
+
             std::unordered_map<std::type_index, Component> components;
+            std::vector<Slot> slots;
+            std::vector<std::unique_ptr<Component::State>> states;
+            std::unordered_map<std::type_index, Component::State *> implStates; // by the impl type.
+            std::atomic<bool> frozen{false};
+            Injector *injector = nullptr; // owner, passed to the generated wiring.
+            IJ *parent = nullptr;         // of child scope.
+            std::unique_ptr<Arena> arena; // of child scope.
+            std::mutex plansMutex;
+            std::unordered_map<const Component::State *, std::unique_ptr<Component::InjectionPlan>> plans; // of components bound to the parent.
+            std::mutex asyncMutex;
+            std::exception_ptr asyncError;
+            std::mutex createdMutex;
+            std::vector<Component::State *> created; // static instances in order of creation.
+            std::atomic<bool> down{false};
+            std::once_flag asyncOnce;
+            // runs INIT_ASYNC methods, declared last so that it is destroyed first: the running
+            // tasks are joined while all the members they touch are alive.
+            std::unique_ptr<WorkerPool> asyncPool;
 
             IJ()
             {
@@ -129,16 +578,398 @@ namespace fog
                 {
                     return &it->second;
                 }
-                return nullptr;
+                return parent ? (*parent)(tid) : nullptr;
+            }
+
+            Arena *getArena() const
+            {
+                return arena.get();
+            }
+
+            std::shared_future<void> runAsync(std::function<void()> task)
+            {
+                std::call_once(asyncOnce, [this]()
+                               { asyncPool = std::make_unique<WorkerPool>(); });
+                auto promise = std::make_shared<std::promise<void>>();
+                std::shared_future<void> ret = promise->get_future().share();
+                asyncPool->submit([this, task, promise]()
+                                  {
+                                      try
+                                      {
+                                          task();
+                                          promise->set_value();
+                                      }
+                                      catch (...)
+                                      {
+                                          promise->set_exception(std::current_exception());
+                                          std::lock_guard<std::mutex> lock(asyncMutex);
+                                          asyncError = asyncError ? asyncError : std::current_exception();
+                                      } });
+                return ret;
+            }
+
+            void waitAsync()
+            {
+                if (WorkerPool *pool = asyncPool.get())
+                {
+                    pool->wait();
+                }
+                std::exception_ptr error;
+                {
+                    std::lock_guard<std::mutex> lock(asyncMutex);
+                    std::swap(error, asyncError);
+                }
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+
+            // compiled outside of the lock, it may resolve other components.
+            template <typename F>
+            const Component::InjectionPlan &scopedPlan(const Component::State &state, F &&compile)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(plansMutex);
+                    if (auto it = plans.find(&state); it != plans.end())
+                    {
+                        return *it->second;
+                    }
+                }
+                std::unique_ptr<Component::InjectionPlan> plan = std::make_unique<Component::InjectionPlan>();
+                compile(*plan);
+                std::lock_guard<std::mutex> lock(plansMutex);
+                return *plans.emplace(&state, std::move(plan)).first->second; // the first one if compiled concurrently.
+            }
+
+            void onCreated(Component::State &state)
+            {
+                std::lock_guard<std::mutex> lock(createdMutex);
+                created.push_back(&state);
+            }
+
+            bool isShutDown() const
+            {
+                return down.load(std::memory_order_acquire);
+            }
+
+            void shutdown()
+            {
+                if (WorkerPool *pool = asyncPool.get())
+                {
+                    pool->wait(); // no INIT_ASYNC running on the instances.
+                }
+                down.store(true, std::memory_order_release);
+                std::vector<Component::State *> list;
+                {
+                    std::lock_guard<std::mutex> lock(createdMutex);
+                    std::swap(list, created);
+                }
+                for (Slot &slot : slots)
+                {
+                    slot.instance.store(nullptr, std::memory_order_release);
+                }
+                std::exception_ptr error;
+                for (auto it = list.rbegin(); it != list.rend(); it++)
+                {
+                    try
+                    {
+                        Component::Impl::destroyStatic(**it, arena != nullptr);
+                    }
+                    catch (...)
+                    {
+                        error = error ? error : std::current_exception();
+                    }
+                }
+                for (const auto &state : states)
+                {
+                    if (state->pool)
+                    {
+                        state->pool->clear();
+                    }
+                }
+                if (arena)
+                {
+                    arena->release();
+                }
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+
+            LiveStats getLiveStats()
+            {
+                LiveStats ret;
+                if (!arena) // otherwise counted by the arena.
+                {
+                    std::lock_guard<std::mutex> lock(createdMutex);
+                    for (const Component::State *state : created)
+                    {
+                        ret.objects++;
+                        ret.bytes += state->size;
+                    }
+                }
+                for (const auto &state : states)
+                {
+                    if (state->pool)
+                    {
+                        std::size_t idle = state->pool->getStats().idle;
+                        ret.objects += idle;
+                        ret.bytes += idle * state->size;
+                    }
+                }
+                if (arena)
+                {
+                    ret.objects += arena->getObjects();
+                    ret.bytes += arena->getBytes();
+                }
+                return ret;
+            }
+
+            void assertNotFrozen() const
+            {
+                if (frozen.load(std::memory_order_acquire))
+                {
+                    throw std::runtime_error("injector is frozen, cannot bind any more.");
+                }
             }
 
             void bindComp(Component comp)
             {
+                assertNotFrozen();
                 if (components.find(comp.typeId) != components.end())
                 {
+                    dropUnused(comp.state);
                     throw std::runtime_error("type id already bond, cannot bind, you may need rebind method.");
                 }
-                components.emplace(comp.typeId, comp);
+                auto it = components.emplace(comp.typeId, comp).first;
+                std::size_t id = TypeIds::of(comp.typeId);
+                if (slots.size() <= id)
+                {
+                    slots.resize(id + 1);
+                }
+                slots[id].comp = &it->second;
+            }
+
+            // shared by all bindings of the impl type.
+            Component::State &makeState(std::type_index implType)
+            {
+                assertNotFrozen();
+                if (auto it = implStates.find(implType); it != implStates.end())
+                {
+                    return *it->second;
+                }
+                states.push_back(std::make_unique<Component::State>());
+                return *implStates.emplace(implType, states.back().get()).first->second;
+            }
+
+            // the state made for a binding that failed.
+            void dropUnused(const Component::State *state)
+            {
+                if (!state)
+                {
+                    return;
+                }
+                for (const auto &pair : components)
+                {
+                    if (pair.second.state == state)
+                    {
+                        return;
+                    }
+                }
+                for (auto it = implStates.begin(); it != implStates.end(); it++)
+                {
+                    if (it->second == state)
+                    {
+                        implStates.erase(it);
+                        break;
+                    }
+                }
+                states.erase(std::find_if(states.begin(), states.end(), [state](const std::unique_ptr<Component::State> &ptr)
+                                          { return ptr.get() == state; }));
+            }
+
+            template <typename T>
+            const Component *find() const
+            {
+                std::size_t id = TypeIds::of<T>();
+                if (id < slots.size() && slots[id].comp)
+                {
+                    return slots[id].comp;
+                }
+                return parent ? parent->find<T>() : nullptr;
+            }
+
+            template <typename T>
+            const Component &resolve() const
+            {
+                if (const Component *comp = find<T>())
+                {
+                    return *comp;
+                }
+                throw std::runtime_error("must bind before get the instance by type from Injector.");
+            }
+
+            Slot &getSlot(std::size_t id)
+            {
+                if (id < slots.size() && slots[id].comp)
+                {
+                    return slots[id];
+                }
+                throw std::runtime_error("must bind before get the instance by type from Injector.");
+            }
+
+            /**
+             * Dependency graph of the components made by impl, built by validate().
+             */
+            struct Graph
+            {
+                std::vector<const Component *> order; // creation order, dependencies first.
+                std::unordered_map<const Component *, std::vector<const Component *>> dependencies;
+            };
+            Graph graph;
+
+            std::vector<std::string> validate()
+            {
+                std::vector<std::string> problems;
+                Graph g;
+                for (const auto &pair : components)
+                {
+                    if (pair.second.singleton)
+                    {
+                        g.dependencies.emplace(&pair.second, dependenciesOf(pair.second, problems));
+                    }
+                }
+
+                std::unordered_map<const Component *, int> marks; // 1: visiting, 2: done.
+                std::vector<const Component *> path;
+                std::function<void(const Component *)> visit = [&](const Component *comp)
+                {
+                    marks[comp] = 1;
+                    path.push_back(comp);
+                    for (const Component *dep : g.dependencies[comp])
+                    {
+                        if (g.dependencies.find(dep) == g.dependencies.end())
+                        {
+                            continue; // not made by impl, no dependency known.
+                        }
+                        if (marks[dep] == 1)
+                        {
+                            std::string cycle;
+                            for (auto it = std::find(path.begin(), path.end(), dep); it != path.end(); it++)
+                            {
+                                cycle += TypeIds::nameOf((*it)->typeId) + " -> ";
+                            }
+                            problems.push_back("dependency cycle: " + cycle + TypeIds::nameOf(dep->typeId));
+                        }
+                        else if (marks[dep] == 0)
+                        {
+                            visit(dep);
+                        }
+                    }
+                    path.pop_back();
+                    marks[comp] = 2;
+                    g.order.push_back(comp);
+                };
+                for (const auto &pair : components)
+                {
+                    if (pair.second.singleton && marks[&pair.second] == 0)
+                    {
+                        visit(&pair.second);
+                    }
+                }
+                graph = std::move(g);
+                return problems;
+            }
+
+            /**
+             * Bound components the constructor arguments and registered members of comp resolved
+             * from, what cannot be resolved is added to problems.
+             */
+            std::vector<const Component *> dependenciesOf(const Component &comp, std::vector<std::string> &problems) const
+            {
+                std::vector<const Component *> ret;
+                std::string name = TypeIds::nameOf(comp.typeId);
+                for (std::size_t i = 0; i < comp.dependencies.size(); i++)
+                {
+                    const Component::Dependency &dep = comp.dependencies[i];
+                    const Component *cPtr = (*this)(dep.type);
+                    if (!cPtr && (dep.eager || dep.kind == ArgKind::Value)) // the kinds resolved from ArgOfConstructor too.
+                    {
+                        cPtr = (*this)(dep.fallback);
+                    }
+                    if (!cPtr)
+                    {
+                        problems.push_back(fmt::format("{}: no component bound for arg {} of constructor, type: {}", name, i, TypeIds::nameOf(dep.type)));
+                    }
+                    else if (dep.kind != ArgKind::Lazy) // all others are resolved or created by the constructor call.
+                    {
+                        ret.push_back(cPtr);
+                    }
+                }
+                if (const AutoRegisteredObjects::ObjectInfo *objInfo = comp.objectInfo ? comp.objectInfo() : nullptr)
+                {
+                    for (const auto &fieldPair : objInfo->members)
+                    {
+                        const AutoRegisteredObjects::MemberInfo &mebInfo = fieldPair.second;
+                        if (mebInfo.makeLazy)
+                        {
+                            if (!(*this)(mebInfo.lazyType))
+                            {
+                                problems.push_back(fmt::format("{}: no component bound for lazy member:{}, type: {}", name, fieldPair.first, TypeIds::nameOf(mebInfo.lazyType)));
+                            }
+                            continue; // not created before.
+                        }
+                        if (const Component *cPtr = (*this)(mebInfo.vType))
+                        {
+                            ret.push_back(cPtr);
+                            continue;
+                        }
+                        ConfigSource src;
+                        std::any val;
+                        try
+                        {
+                            if ((comp.members && comp.members(mebInfo.vType, fieldPair.first, mebInfo.key, src, false)) || mebInfo.defaultVal(val))
+                            {
+                                continue;
+                            }
+                            problems.push_back(fmt::format("{}: cannot resolve the value for member:{},key:{}", name, fieldPair.first, mebInfo.key));
+                        }
+                        catch (const std::exception &e)
+                        {
+                            problems.push_back(fmt::format("{}: cannot resolve the value for member:{},key:{}({})", name, fieldPair.first, mebInfo.key, e.what()));
+                        }
+                    }
+                }
+                return ret;
+            }
+
+            void createStatic(const Component &comp)
+            {
+                void *ptr = comp.rawS.at(comp.typeId)();
+                slots[TypeIds::of(comp.typeId)].instance.store(ptr, std::memory_order_release);
+            }
+
+            template <typename T>
+            T *getStatic()
+            {
+                std::size_t id = TypeIds::of<T>();
+                if (parent && (id >= slots.size() || !slots[id].comp))
+                {
+                    return parent->getStatic<T>(); // inherited.
+                }
+                Slot &slot = getSlot(id);
+                if (void *ptr = slot.instance.load(std::memory_order_acquire))
+                {
+                    return static_cast<T *>(ptr);
+                }
+                T *ptr = slot.comp->template get<T>(Component::AsStatic);
+                if (slot.comp->singleton)
+                {
+                    slot.instance.store(ptr, std::memory_order_release);
+                }
+                return ptr;
             }
 
             Component &getComponent(std::type_index tid)
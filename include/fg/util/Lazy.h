@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#pragma once
+#include "Common.h"
+
+namespace fog
+{
+    /**
+     * Deferred reference of a static instance, nothing is created until the first dereference.
+     *
+     * Resolving is thread-safe and happens once, copies of a lazy share the resolved pointer,
+     * afterwards get() is a plain pointer load. A Lazy<T> can be declared as argument of an
+     * INJECT constructor or as type of a registered member, it then refers to the injector that
+     * made it, which must outlive its first dereference. A default constructed lazy refers to
+     * nothing, get() throws.
+     */
+    template <typename T>
+    struct Lazy
+    {
+        Lazy() = default;
+
+        explicit Lazy(std::function<T *()> resolve) : state(std::make_shared<State>(resolve))
+        {
+        }
+
+        T *get() const
+        {
+            if (!state)
+            {
+                throw std::runtime_error("lazy is empty, nothing to resolve.");
+            }
+            if (T *ptr = state->ptr.load(std::memory_order_acquire))
+            {
+                return ptr;
+            }
+            State *s = state.get();
+            std::call_once(s->once, [s]()
+                           { s->ptr.store(s->resolve(), std::memory_order_release); });
+            return s->ptr.load(std::memory_order_acquire);
+        }
+
+        T *operator->() const
+        {
+            return get();
+        }
+
+        T &operator*() const
+        {
+            return *get();
+        }
+
+        bool isResolved() const
+        {
+            return state && state->ptr.load(std::memory_order_acquire);
+        }
+
+    private:
+        struct State
+        {
+            std::function<T *()> resolve;
+            std::once_flag once;
+            std::atomic<T *> ptr{nullptr};
+            State(std::function<T *()> resolve) : resolve(resolve)
+            {
+            }
+        };
+        std::shared_ptr<State> state;
+    };
+
+    template <typename T>
+    struct isLazy : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct isLazy<Lazy<T>> : std::true_type
+    {
+        using Type = T;
+    };
+};
@@ -0,0 +1,173 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#pragma once
+#include "Options.h"
+#include "OptionsLoader.h"
+
+namespace fog
+{
+    /**
+     * Config that can be reloaded while it is read, in the way of RCU.
+     *
+     * Each publish freezes the groups into a new immutable snapshot with a new version and
+     * swaps it in, the snapshots are never modified. A reader thread keeps the snapshot it got
+     * last with its version, per instance, read() is one relaxed load of the current version and
+     * a compare while nothing is published, the new snapshot is fetched under the lock only once
+     * per thread after a publish. An old snapshot is freed when the last thread that read it
+     * reads the same instance again(or exits, or calls release()).
+     */
+    struct LiveConfig
+    {
+        struct Snapshot
+        {
+            std::uint64_t version;
+            Options::Frozen options;
+        };
+
+        LiveConfig() : slot(acquireSlot())
+        {
+            publish(Options::Groups{});
+        }
+
+        explicit LiveConfig(const Options::Groups &groups) : slot(acquireSlot())
+        {
+            publish(groups);
+        }
+
+        // the snapshots kept by reader threads are freed when they exit or read the next owner
+        // of the slot.
+        ~LiveConfig()
+        {
+            releaseSlot(slot);
+        }
+
+        LiveConfig(const LiveConfig &) = delete;
+        LiveConfig &operator=(const LiveConfig &) = delete;
+
+        /**
+         * Freezes the groups into a new snapshot and makes it the current one.
+         */
+        std::uint64_t publish(const Options::Groups &groups)
+        {
+            std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>(Snapshot{nextVersion(), groups.freeze()});
+            std::uint64_t ver = snapshot->version;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                current = std::move(snapshot);
+                version.store(ver, std::memory_order_release);
+            }
+            return ver;
+        }
+
+        std::uint64_t reload(std::vector<std::string> files, bool strict)
+        {
+            Options::Groups groups;
+            OptionsLoader().load(files, groups, strict);
+            return publish(groups);
+        }
+
+        /**
+         * The current snapshot, valid on the calling thread until its next read() of this
+         * LiveConfig, use acquire() to keep it longer.
+         */
+        const Snapshot &read() const
+        {
+            Cache &cache = getCache(slot);
+            if (cache.version != version.load(std::memory_order_relaxed))
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                cache.snapshot = current;
+                cache.version = current->version;
+            }
+            return *cache.snapshot;
+        }
+
+        std::shared_ptr<const Snapshot> acquire() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return current;
+        }
+
+        std::uint64_t getVersion() const
+        {
+            return version.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Drops the snapshot of this instance kept by the calling thread, for a thread that stops
+         * reading it.
+         */
+        void release() const
+        {
+            Cache &cache = getCache(slot);
+            cache.snapshot = nullptr;
+            cache.version = 0;
+        }
+
+    private:
+        struct Cache
+        {
+            std::uint64_t version = 0;
+            std::shared_ptr<const Snapshot> snapshot;
+        };
+
+        // index of the cache of this instance in the caches of each thread, reused after the
+        // instance is destroyed. versions are unique across all instances, so a cache left by a
+        // former owner of the slot never matches and is refreshed on the first read.
+        const std::size_t slot;
+        mutable std::mutex mutex;
+        std::shared_ptr<const Snapshot> current;
+        std::atomic<std::uint64_t> version{0};
+
+        static Cache &getCache(std::size_t slot)
+        {
+            thread_local std::vector<Cache> caches;
+            if (slot >= caches.size())
+            {
+                caches.resize(slot + 1);
+            }
+            return caches[slot];
+        }
+
+        struct Slots
+        {
+            std::mutex mutex;
+            std::size_t next = 0;
+            std::vector<std::size_t> free;
+        };
+
+        static Slots &slots()
+        {
+            static Slots slots;
+            return slots;
+        }
+
+        static std::size_t acquireSlot()
+        {
+            Slots &s = slots();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            if (s.free.empty())
+            {
+                return s.next++;
+            }
+            std::size_t ret = s.free.back();
+            s.free.pop_back();
+            return ret;
+        }
+
+        static void releaseSlot(std::size_t slot)
+        {
+            Slots &s = slots();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.free.push_back(slot);
+        }
+
+        static std::uint64_t nextVersion()
+        {
+            static std::atomic<std::uint64_t> counter{0};
+            return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+    };
+};
@@ -0,0 +1,194 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#pragma once
+#include <string>
+#include <string_view>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fog
+{
+    /**
+     * Read-only memory mapping of a whole file, the content is viewed in place without copy.
+     * A file that cannot be mapped or reports no size(pipe, device, procfs) is read into a
+     * buffer instead. The file must not be truncated while mapped: on POSIX, reading the pages
+     * cut off raises SIGBUS, on Windows the truncation fails.
+     */
+    class MappedFile
+    {
+        const char *data_ = nullptr; // of the mapping.
+        std::size_t size_ = 0;
+        std::string buffer; // content of a file read instead of mapped.
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#else
+        int fd = -1;
+#endif
+
+    public:
+        explicit MappedFile(const std::string &path)
+        {
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                throw std::runtime_error("failed to open file for read: " + path);
+            }
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size))
+            {
+                close();
+                throw std::runtime_error("failed to get size of file: " + path);
+            }
+            size_ = static_cast<std::size_t>(size.QuadPart);
+            if (size_ == 0 || GetFileType(file) != FILE_TYPE_DISK)
+            {
+                readAll(path);
+                return;
+            }
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping)
+            {
+                data_ = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            }
+#else
+            fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::runtime_error("failed to open file for read: " + path);
+            }
+            struct stat st;
+            if (::fstat(fd, &st) != 0)
+            {
+                close();
+                throw std::runtime_error("failed to get size of file: " + path);
+            }
+            size_ = static_cast<std::size_t>(st.st_size);
+            if (size_ == 0 || !S_ISREG(st.st_mode))
+            {
+                readAll(path);
+                return;
+            }
+            void *ptr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (ptr != MAP_FAILED)
+            {
+                data_ = static_cast<const char *>(ptr);
+#ifdef POSIX_MADV_SEQUENTIAL
+                ::posix_madvise(ptr, size_, POSIX_MADV_SEQUENTIAL);
+#endif
+            }
+#endif
+            if (!data_)
+            {
+                close();
+                throw std::runtime_error("failed to map file: " + path);
+            }
+        }
+
+        ~MappedFile()
+        {
+            close();
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        std::string_view view() const
+        {
+            return data_ ? std::string_view(data_, size_) : std::string_view(buffer);
+        }
+
+        std::size_t size() const
+        {
+            return size_;
+        }
+
+    private:
+        void readAll(const std::string &path)
+        {
+            char chunk[64 * 1024];
+            while (true)
+            {
+#ifdef _WIN32
+                DWORD n = 0;
+                if (!ReadFile(file, chunk, sizeof(chunk), &n, nullptr))
+                {
+                    if (GetLastError() == ERROR_BROKEN_PIPE)
+                    {
+                        break; // end of a pipe.
+                    }
+                    close();
+                    throw std::runtime_error("failed to read file: " + path);
+                }
+#else
+                ssize_t n = ::read(fd, chunk, sizeof(chunk));
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n < 0)
+                {
+                    close();
+                    throw std::runtime_error("failed to read file: " + path);
+                }
+#endif
+                if (n == 0)
+                {
+                    break;
+                }
+                buffer.append(chunk, static_cast<std::size_t>(n));
+            }
+            size_ = buffer.size();
+            close();
+        }
+
+        void close()
+        {
+#ifdef _WIN32
+            if (data_)
+            {
+                UnmapViewOfFile(data_);
+            }
+            if (mapping)
+            {
+                CloseHandle(mapping);
+            }
+            if (file != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(file);
+            }
+            mapping = nullptr;
+            file = INVALID_HANDLE_VALUE;
+#else
+            if (data_)
+            {
+                ::munmap(const_cast<char *>(data_), size_);
+            }
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            fd = -1;
+#endif
+            data_ = nullptr;
+        }
+    };
+};
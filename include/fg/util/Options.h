@@ -4,12 +4,65 @@
  */
 #pragma once
 #include "Common.h"
+#include <cstdint>
+#include <string_view>
+#include <utility>
 
 namespace fog
 {
 
     struct Options
     {
+        /**
+         * Key of an option, a view of the name with its hash computed once. The "name"_k literal
+         * computes the hash at compile time, so a lookup by literal neither allocates nor hashes,
+         * a std::string or std::string_view is hashed once when converted. The view must stay
+         * valid during the call it is passed to, so the conversion from std::string is explicit,
+         * a temporary string cannot silently become a key that outlives it.
+         */
+        struct Key
+        {
+            std::string_view name;
+            std::size_t hash;
+
+            constexpr Key(std::string_view name) : name(name), hash(hashOf(name))
+            {
+            }
+            constexpr Key(const char *name) : Key(std::string_view(name))
+            {
+            }
+            explicit Key(const std::string &name) : Key(std::string_view(name))
+            {
+            }
+            constexpr Key(std::string_view name, std::size_t hash) : name(name), hash(hash)
+            {
+            }
+
+            constexpr bool operator==(const Key &key) const
+            {
+                return hash == key.hash && name == key.name;
+            }
+
+            // FNV-1a.
+            static constexpr std::size_t hashOf(std::string_view str)
+            {
+                std::uint64_t h = 14695981039346656037ull;
+                for (char c : str)
+                {
+                    h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+                }
+                return static_cast<std::size_t>(h);
+            }
+
+            struct Hash
+            {
+                std::size_t operator()(const Key &key) const
+                {
+                    return key.hash;
+                }
+            };
+        };
+
         struct Ref
         {
             std::string group;
@@ -23,122 +76,491 @@ namespace fog
             Ref &operator=(Ref &&) = default;
         };
 
+        /**
+         * Named value of any copyable type. Small values(int, float, bool, Range2<int>...) are
+         * stored inline, larger ones(std::string, Ref...) on the heap, the type specific
+         * operations are a single static table per type, so copying a small option allocates
+         * nothing but the name.
+         */
         struct Option
         {
             std::string name;
-            std::any valuePtr;
-            std::function<void(std::any)> destructor;
-            std::function<std::any()> copy;
-            std::function<std::any()> value;
-            std::type_index valueType;
-            ~Option()
-            {
-                destructor(this->valuePtr);
-            }
+
             template <typename T>
-            Option(std::string name, T defaultV) : name(name),valueType(typeid(T))
+            Option(std::string name, T defaultV) : name(name), ops(&OpsOf<T>::ops)
             {
-                this->copy = [defaultV]()
-                {
-                    T *valueP = new T(defaultV);
-                    return std::make_any<T *>(valueP);
-                };
-                this->valuePtr = copy();
-                this->destructor = [](std::any valuePtr)
-                {
-                    T *valueP = std::any_cast<T *>(valuePtr);
-                    delete valueP;
-                };
-                this->value = [this]()
-                {
-                    T *valueP = std::any_cast<T *>(valuePtr);
-                    return std::make_any<T>(*valueP);
-                };
-                this->valueType = typeid(T);
+                OpsOf<T>::construct(*this, std::move(defaultV));
             }
 
-            Option(const Option &opt) : name(opt.name),valueType(opt.valueType)
+            Option(const Option &opt) : name(opt.name), ops(opt.ops)
             {
-                doCopy(opt);
+                ops->copy(opt, *this);
             }; // copy
 
-            Option(Option &&opt) : name(opt.name),valueType(opt.valueType)
+            Option(Option &&opt) : name(opt.name), ops(opt.ops)
             {
                 doMove(opt);
-                
             }; // move
-            private:
-            void doCopy(const Option &opt){
-
-                this->copy = opt.copy;
-                this->destructor = opt.destructor;
-                this->valuePtr = this->copy();
-                this->value = opt.value;
-            }
-
-            void doMove(Option &opt){
-                this->copy = opt.copy;
-                this->destructor = opt.destructor;
-                this->valuePtr = opt.valuePtr;
-                opt.destructor = [](std::any) {}; //
-                opt.copy = []() -> std::any
-                { return nullptr; };
-                opt.valuePtr = opt.copy();
-                opt.value = []() -> std::any
-                { throw std::runtime_error("empty value."); };
-            }
-            
-            public:
-            
+
+            ~Option()
+            {
+                ops->destroy(*this);
+            }
+
+            // the value only, the name is kept since the key of the option in its Options views it.
             Option &operator=(const Option &opt)
             {
-                this->name = opt.name;
-                this->valueType = opt.valueType;
-                //
-                doCopy(opt);
+                if (this != &opt)
+                {
+                    ops->destroy(*this);
+                    this->ops = &emptyOps; // in case the copy throws.
+                    opt.ops->copy(opt, *this);
+                    this->ops = opt.ops;
+                }
                 return *this;
             }; // copy assign
 
             Option &operator=(Option &&opt)
             {
-                this->name = opt.name;
-                this->valueType = opt.valueType;
-                //
-                doMove(opt);
+                if (this != &opt)
+                {
+                    ops->destroy(*this);
+                    this->ops = opt.ops;
+                    doMove(opt);
+                }
                 return *this;
             }; // move assign
 
             template <typename T>
             bool isType() const
             {
-                return valuePtr.type() == typeid(T *);
+                return *ops->type == typeid(T);
+            }
+
+            std::type_index getType() const
+            {
+                return *ops->type;
             }
-            std::type_index getType(){
-                return valueType;
+
+            template <typename T>
+            const T &getValueRef() const
+            {
+                if (!isType<T>())
+                {
+                    throw std::bad_any_cast();
+                }
+                return *OpsOf<T>::get(*this);
             }
 
             template <typename T>
-            T &getValueRef() const
+            T &getValueRef()
+            {
+                if (!isType<T>())
+                {
+                    throw std::bad_any_cast();
+                }
+                return *OpsOf<T>::get(*this);
+            }
+
+            std::any getValue() const
             {
-                T *p = std::any_cast<T *>(valuePtr);
-                return *p;
+                return ops->value(*this);
             }
 
-            std::any getValue(){
-                return this->value();
+            // address of the value, of the type given by getType().
+            const void *data() const
+            {
+                return ops->data(*this);
+            }
+
+        private:
+            friend struct Options;
+
+            struct Ops
+            {
+                const std::type_info *type;
+                void (*copy)(const Option &from, Option &to);
+                void (*move)(Option &from, Option &to); // from is left destroyed.
+                void (*destroy)(Option &opt);
+                std::any (*value)(const Option &opt);
+                const void *(*data)(const Option &opt);
+            };
+
+            union Storage
+            {
+                alignas(8) unsigned char buf[16];
+                void *heap;
+            };
+
+            template <typename T>
+            static constexpr bool isInline = sizeof(T) <= sizeof(Storage) && alignof(T) <= alignof(Storage) && //
+                                             std::is_nothrow_move_constructible_v<T>;
+
+            template <typename T>
+            struct OpsOf
+            {
+                static T *get(const Option &opt)
+                {
+                    if constexpr (isInline<T>)
+                    {
+                        return std::launder(reinterpret_cast<T *>(const_cast<unsigned char *>(opt.storage.buf)));
+                    }
+                    else
+                    {
+                        return static_cast<T *>(opt.storage.heap);
+                    }
+                }
+
+                template <typename V>
+                static void construct(Option &opt, V &&value)
+                {
+                    if constexpr (isInline<T>)
+                    {
+                        new (opt.storage.buf) T(std::forward<V>(value));
+                    }
+                    else
+                    {
+                        opt.storage.heap = new T(std::forward<V>(value));
+                    }
+                }
+
+                static void copy(const Option &from, Option &to)
+                {
+                    construct(to, *get(from));
+                }
+
+                static void move(Option &from, Option &to)
+                {
+                    if constexpr (isInline<T>)
+                    {
+                        construct(to, std::move(*get(from)));
+                        get(from)->~T();
+                    }
+                    else
+                    {
+                        to.storage.heap = from.storage.heap;
+                    }
+                }
+
+                static void destroy(Option &opt)
+                {
+                    if constexpr (isInline<T>)
+                    {
+                        get(opt)->~T();
+                    }
+                    else
+                    {
+                        delete get(opt);
+                    }
+                }
+
+                static std::any value(const Option &opt)
+                {
+                    return std::make_any<T>(*get(opt));
+                }
+
+                static const void *data(const Option &opt)
+                {
+                    return get(opt);
+                }
+
+                static constexpr Ops ops{&typeid(T), &copy, &move, &destroy, &value, &data};
+            };
+
+            // of a moved-from option.
+            static constexpr Ops emptyOps{
+                &typeid(void),
+                [](const Option &, Option &) {},
+                [](Option &, Option &) {},
+                [](Option &) {},
+                [](const Option &) -> std::any
+                { throw std::runtime_error("empty value."); },
+                [](const Option &) -> const void *
+                { return nullptr; }};
+
+            const Ops *ops;
+            Storage storage;
+            bool pinned = false; // handed out for write, never shared. not copied with the value.
+
+            void doMove(Option &opt)
+            {
+                opt.ops->move(opt, *this);
+                opt.ops = &emptyOps;
             }
         };
 
+        struct Frozen;
+
         struct Groups
         {
             std::unordered_map<std::string, Options> groups;
+
+            /**
+             * Immutable snapshot of all groups, for configs that do not change once loaded.
+             */
+            Frozen freeze() const;
+        };
+
+        /**
+         * Options of all groups compacted into contiguous arrays: the options ordered by group
+         * then by hash of the name, and a parallel array of the hashes. A lookup is a binary
+         * search on the hashes of the group and a compare of the name found.
+         */
+        struct Frozen
+        {
+            /**
+             * Read-only view of a group of the snapshot, empty if the group does not exist. It
+             * refers to the arrays of the snapshot, so it is valid while the snapshot lives.
+             */
+            struct View
+            {
+                const Option *getOption(Key name) const
+                {
+                    for (const std::size_t *it = std::lower_bound(hashes, hashes + count, name.hash); it != hashes + count && *it == name.hash; it++)
+                    {
+                        const Option &opt = values[it - hashes];
+                        if (opt.name == name.name)
+                        {
+                            return &opt;
+                        }
+                    }
+                    return nullptr;
+                }
+
+                template <typename T>
+                const T *find(Key name) const
+                {
+                    const Option *opt = getOption(name);
+                    if (!opt)
+                    {
+                        return nullptr;
+                    }
+                    if (!opt->isType<T>())
+                    {
+                        throw std::runtime_error(fmt::format("type of option:{} is mismatch.", name.name));
+                    }
+                    return &opt->getValueRef<T>();
+                }
+
+                template <typename T>
+                T get(Key name, T defValue) const
+                {
+                    const T *value = find<T>(name);
+                    return value ? *value : defValue;
+                }
+
+                template <typename F>
+                void forEach(F &&visit) const
+                {
+                    for (std::size_t i = 0; i < count; i++)
+                    {
+                        visit(values[i].name, &values[i]);
+                    }
+                }
+
+                std::size_t size() const
+                {
+                    return count;
+                }
+
+                bool empty() const
+                {
+                    return count == 0;
+                }
+
+            private:
+                friend struct Frozen;
+                const std::size_t *hashes;
+                const Option *values;
+                std::size_t count;
+
+                View(const std::size_t *hashes, const Option *values, std::size_t count) : hashes(hashes), values(values), count(count)
+                {
+                }
+            };
+
+            View group(Key name) const
+            {
+                for (const GroupEntry &ge : groups)
+                {
+                    if (ge.hash == name.hash && ge.name == name.name)
+                    {
+                        return View(hashes.data() + ge.begin, values.data() + ge.begin, ge.end - ge.begin);
+                    }
+                }
+                return View(nullptr, nullptr, 0);
+            }
+
+            template <typename T>
+            T get(Key group, Key name, T defValue) const
+            {
+                return this->group(group).get<T>(name, defValue);
+            }
+
+        private:
+            friend struct Groups;
+
+            struct GroupEntry
+            {
+                std::size_t hash;
+                std::string name;
+                std::size_t begin;
+                std::size_t end;
+            };
+
+            std::vector<GroupEntry> groups; // a few per config, scanned linearly.
+            std::vector<std::size_t> hashes;
+            std::vector<Option> values;
+        };
+
+        /**
+         * Ordered stack of immutable layers(defaults at the bottom, overrides pushed on top), a
+         * lookup returns the option of the topmost layer that has it. Composing is a push of a
+         * pointer, no option is copied.
+         */
+        struct Layers
+        {
+            void push(std::shared_ptr<const Options> layer)
+            {
+                layers.push_back(std::move(layer));
+            }
+
+            const Option *getOption(Key name) const
+            {
+                for (auto it = layers.rbegin(); it != layers.rend(); it++)
+                {
+                    if (const Option *opt = (*it)->getOption(name))
+                    {
+                        return opt;
+                    }
+                }
+                return nullptr;
+            }
+
+            template <typename T>
+            T get(Key name, T defValue) const
+            {
+                const Option *opt = getOption(name);
+                if (!opt)
+                {
+                    return defValue;
+                }
+                if (opt->isType<T>())
+                {
+                    return opt->getValueRef<T>();
+                }
+                throw std::runtime_error(fmt::format("type of option:{} is mismatch.", name.name));
+            }
+
+            // visible options only, the ones hidden by an upper layer are skipped.
+            template <typename F>
+            void forEach(F &&visit) const
+            {
+                for (auto it = layers.rbegin(); it != layers.rend(); it++)
+                {
+                    for (const auto &pair : (*it)->options)
+                    {
+                        if (getOption(pair.first) == pair.second.get())
+                        {
+                            visit(pair.second->name, static_cast<const Option *>(pair.second.get()));
+                        }
+                    }
+                }
+            }
+
+            // options of all layers in one, sharing the values with the layers.
+            Options flatten() const
+            {
+                Options opts;
+                for (auto it = layers.rbegin(); it != layers.rend(); it++)
+                {
+                    opts.merge(**it);
+                }
+                return opts;
+            }
+
+            std::size_t size() const
+            {
+                return layers.size();
+            }
+
+        private:
+            std::vector<std::shared_ptr<const Options>> layers; // bottom first.
         };
 
+        /**
+         * Typed access to an option resolved once: the name is looked up and the type checked
+         * when the handle is made and again only after options are added, replaced or assigned
+         * (the generation of the options changed), a read is otherwise a compare and a
+         * dereference. The handle refers to the Options it was made from, which must outlive
+         * it, and is not thread safe. It does not apply to Frozen snapshots or LiveConfig, a new
+         * snapshot is a different object, look up in the snapshot got by each read instead.
+         */
+        template <typename T>
+        struct Handle
+        {
+            Handle(const Options &opts, Key name, T defValue) : opts(&opts), name(name.name), hash(name.hash), defValue(std::move(defValue))
+            {
+                resolve();
+            }
+
+            const T &get() const
+            {
+                if (generation != opts->generation)
+                {
+                    resolve();
+                }
+                return value ? *value : defValue;
+            }
+
+            const T &operator*() const
+            {
+                return get();
+            }
+
+            operator const T &() const
+            {
+                return get();
+            }
+
+            // false if the default value is used.
+            bool exists() const
+            {
+                get();
+                return value != nullptr;
+            }
+
+        private:
+            const Options *opts;
+            std::string name;
+            std::size_t hash;
+            T defValue;
+            mutable const T *value = nullptr;
+            mutable std::uint64_t generation = 0;
+
+            void resolve() const
+            {
+                const Option *opt = opts->getOption(Key(name, hash));
+                if (opt && !opt->isType<T>())
+                {
+                    throw std::runtime_error(fmt::format("type of option:{} is mismatch.", name));
+                }
+                value = opt ? &opt->getValueRef<T>() : nullptr;
+                generation = opts->generation;
+            }
+        };
+
+        template <typename T>
+        Handle<T> handle(Key name, T defValue) const
+        {
+            return Handle<T>(*this, name, std::move(defValue));
+        }
+
     public:
         template <typename T>
-        static T get(Options &opts, std::string name, T defValue)
+        static T get(const Options &opts, Key name, T defValue)
         {
-            Option *opt = opts.getOption(name);
+            const Option *opt = opts.getOption(name);
             if (!opt)
             {
                 return defValue;
@@ -147,20 +569,120 @@ namespace fog
             {
                 return opt->getValueRef<T>();
             }
-            throw std::runtime_error(fmt::format("type of option:{} is mismatch.", name));
+            throw std::runtime_error(fmt::format("type of option:{} is mismatch.", name.name));
+        }
+
+        Options() = default;
+
+        Options(const Options &opts)
+        {
+            shareAll(opts);
+        }
+
+        // the moved-from options get a new generation too, their handles resolve again.
+        Options(Options &&opts) : options(std::move(opts.options))
+        {
+            opts.options.clear();
+            opts.generation = nextGeneration();
+        }
+
+        Options &operator=(const Options &opts)
+        {
+            if (this != &opts)
+            {
+                options.clear();
+                shareAll(opts);
+                generation = nextGeneration();
+            }
+            return *this;
+        }
+
+        Options &operator=(Options &&opts)
+        {
+            if (this != &opts)
+            {
+                options = std::move(opts.options);
+                opts.options.clear();
+                generation = nextGeneration();
+                opts.generation = nextGeneration();
+            }
+            return *this;
         }
 
     protected:
-        std::unordered_map<std::string, std::unique_ptr<Option>> options;
+        // the key of an entry is a view of the name of its option, which must not be renamed after added.
+        // options are shared by copies of Options(merge, replaceAll, copy). An option handed out for
+        // write(non-const getOption, tryAdd, add, forEach) is first copied if shared, then pinned: it
+        // stays owned by this Options alone and copies of Options get a copy of it, so a write through
+        // the pointer never shows in another Options. A const pointer is valid until the option is
+        // replaced, or handed out for write by this Options.
+        std::unordered_map<Key, std::shared_ptr<Option>, Key::Hash> options;
+
+        // unique across all Options, renewed when an option is added or replaced and when assigned,
+        // so a handle never takes the options of another object for its own.
+        std::uint64_t generation = nextGeneration();
+
+        static std::uint64_t nextGeneration()
+        {
+            static std::atomic<std::uint64_t> counter{0};
+            return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        void put(std::size_t hash, std::shared_ptr<Option> opt)
+        {
+            Key key(opt->name, hash);
+            options.emplace(key, std::move(opt));
+            generation = nextGeneration();
+        }
+
+        Option *detach(decltype(options)::iterator it)
+        {
+            if (it->second.use_count() == 1)
+            {
+                return it->second.get();
+            }
+            std::size_t hash = it->first.hash;
+            std::shared_ptr<Option> opt = std::make_shared<Option>(*it->second);
+            options.erase(it); // the key is a view of the shared option.
+            Option *ret = opt.get();
+            put(hash, std::move(opt));
+            return ret;
+        }
+
+        Option *pin(decltype(options)::iterator it)
+        {
+            Option *opt = detach(it);
+            opt->pinned = true;
+            return opt;
+        }
+
+        static std::shared_ptr<Option> share(const std::shared_ptr<Option> &opt)
+        {
+            return opt->pinned ? std::make_shared<Option>(*opt) : opt;
+        }
+
+        void shareAll(const Options &opts)
+        {
+            for (const auto &pair : opts.options)
+            {
+                put(pair.first.hash, share(pair.second));
+            }
+        }
 
     public:
-    public:
-        ~Options()
+        Option *getOption(Key name)
         {
+            auto it = options.find(name);
+            if (it == options.end())
+            {
+                return nullptr;
+            }
+            return pin(it);
         }
-        Option *getOption(std::string name)
+
+        const Option *getOption(Key name) const
         {
-            const auto &it = options.find(name);
+            auto it = options.find(name);
             if (it == options.end())
             {
                 return nullptr;
@@ -169,7 +691,7 @@ namespace fog
         }
 
         template <typename T>
-        Option *add(std::string name, T defaultValue)
+        Option *add(Key name, T defaultValue)
         {
             Option *ret = tryAdd(name, defaultValue);
 
@@ -177,66 +699,158 @@ namespace fog
             {
                 return ret;
             }
-            throw new std::runtime_error("cannot create options with name:" + name);
+            throw new std::runtime_error("cannot create options with name:" + std::string(name.name));
         }
 
         template <typename T>
-        Option *tryAdd(std::string name, T defaultValue)
+        Option *tryAdd(Key name, T defaultValue)
         {
             Option *opt = nullptr;
             auto it = options.find(name);
             if (it == options.end())
             {
-                std::unique_ptr<Option> optionPtr = std::make_unique<Option>(name, defaultValue);
-                //<std::unique_ptr<Option>>
+                std::shared_ptr<Option> optionPtr = std::make_shared<Option>(std::string(name.name), std::move(defaultValue));
                 opt = optionPtr.get();
-                options[name] = std::move(optionPtr);
+                opt->pinned = true;
+                put(name.hash, std::move(optionPtr));
             }
 
             return opt;
         }
 
-        void add(Option &opt)
+        // as tryAdd but the option is not handed out, so it stays shareable(for defaults and loaders).
+        // false if the name exists.
+        template <typename T>
+        bool tryEmplace(Key name, T value)
+        {
+            if (options.find(name) != options.end())
+            {
+                return false;
+            }
+            put(name.hash, std::make_shared<Option>(std::string(name.name), std::move(value)));
+            return true;
+        }
+
+        void add(const Option &opt)
         {
-            if (auto it = options.find(opt.name); it != options.end())
+            Key key(opt.name);
+            if (auto it = options.find(key); it != options.end())
             {
                 throw std::runtime_error("option with name:" + opt.name + " already exists.");
             }
-            options[opt.name] = std::make_unique<Option>(opt);
+            put(key.hash, std::make_shared<Option>(opt));
+        }
+
+        // adds or replaces the option of the same name.
+        void set(std::shared_ptr<Option> opt)
+        {
+            Key key(opt->name);
+            if (auto it = options.find(key); it != options.end())
+            {
+                options.erase(it);
+            }
+            put(key.hash, std::move(opt));
         }
 
+        // options visited for write are pinned(unshared first), a visitor of const options pins nothing.
         template <typename F>
         void forEach(F &&visit)
+        {
+            if constexpr (std::is_invocable_v<F &, const std::string &, const Option *>)
+            {
+                std::as_const(*this).forEach(visit);
+            }
+            else
+            {
+                std::vector<std::pair<std::size_t, std::shared_ptr<Option>>> shared;
+                for (const auto &pair : options)
+                {
+                    if (pair.second.use_count() > 1)
+                    {
+                        shared.emplace_back(pair.first.hash, pair.second);
+                    }
+                }
+                for (const auto &pair : shared)
+                {
+                    detach(options.find(Key(pair.second->name, pair.first))); // not during the loop, it may rehash.
+                }
+                for (const auto &pair : options)
+                {
+                    pair.second->pinned = true;
+                    visit(pair.second->name, pair.second.get());
+                }
+            }
+        }
+
+        template <typename F>
+        void forEach(F &&visit) const
         {
             for (const auto &pair : options)
             {
-                visit(pair.first, pair.second.get());
+                visit(pair.second->name, static_cast<const Option *>(pair.second.get()));
             }
         }
-        void merge(Options &opts)
+
+        // options not in this yet are shared from opts, pinned ones are copied.
+        void merge(const Options &opts)
         {
             for (auto it = opts.options.begin(); it != opts.options.end(); it++)
             {
-
-                std::string key = it->first;
-                if (auto it2 = this->options.find(key); it2 == this->options.end())
+                if (auto it2 = this->options.find(it->first); it2 == this->options.end())
                 {
-
-                    this->options.emplace(it->first, std::make_unique<Option>(*it->second));
+                    put(it->first.hash, share(it->second));
                 } //
                 // ignore duplicated entry.
             }
         }
-        void replaceAll(Options &opts)
+
+        // all options of opts are shared(pinned ones copied), replacing the ones of the same name.
+        void replaceAll(const Options &opts)
         {
             for (auto it = opts.options.begin(); it != opts.options.end(); it++)
             {
+                set(share(it->second));
+            }
+        }
+    };
+
+    inline Options::Frozen Options::Groups::freeze() const
+    {
+        Frozen frozen;
+        std::size_t total = 0;
+        for (const auto &pair : groups)
+        {
+            total += pair.second.options.size();
+        }
+        frozen.groups.reserve(groups.size());
+        frozen.hashes.reserve(total);
+        frozen.values.reserve(total); // no reallocation, options are not moved.
 
-                std::string key = it->first;
+        std::vector<std::pair<std::size_t, const Option *>> sorted;
+        for (const auto &pair : groups)
+        {
+            sorted.clear();
+            for (const auto &entry : pair.second.options)
+            {
+                sorted.emplace_back(entry.first.hash, entry.second.get());
+            }
+            std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b)
+                      { return a.first < b.first; });
 
-                this->options[key] = std::make_unique<Option>(*it->second);
+            std::size_t begin = frozen.values.size();
+            for (const auto &entry : sorted)
+            {
+                frozen.hashes.push_back(entry.first);
+                frozen.values.push_back(*entry.second);
             }
+            frozen.groups.push_back(Frozen::GroupEntry{Key::hashOf(pair.first), pair.first, begin, frozen.values.size()});
         }
-    };
+        return frozen;
+    }
+
+    constexpr Options::Key operator""_k(const char *name, std::size_t len)
+    {
+        return Options::Key(std::string_view(name, len));
+    }
 
 };
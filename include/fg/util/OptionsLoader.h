@@ -4,10 +4,12 @@
  */
 #pragma once
 
+#include <charconv>
 #include <fstream>
 #include <filesystem>
 #include "Options.h"
 #include "Range2.h"
+#include "MappedFile.h"
 namespace fog
 {
 
@@ -33,29 +35,33 @@ namespace fog
             // resolve refs
             for (auto it = optMap.begin(); it != optMap.end(); ++it)
             {
-                std::string group = it->first;
-                Options &opts = optMap[group];
-                Options resolvedOpts;
-                opts.forEach([this, &group, &resolvedOpts, &optMap](std::string key, Options::Option *optPtr)
-                             {
-                                 Options::Option &opt = *optPtr;
-                                 std::unordered_set<std::string> processedFKeys;
-                                 if (opt.isType<Options::Ref>())
-                                 {
-                                     Options::Ref &refV = opt.getValueRef<Options::Ref>();
-                                     Options::Option &opt2 = resolveRef(optMap, refV.group, refV.key, processedFKeys);
-                                     Options::Option opt3 = opt2;
-                                     opt3.name = key;
-                                     resolvedOpts.add(opt3);
-                                     //std::cout << "Resolved ref option: [" << group << "] " << key << " -> " << refV.group << "." << refV.key << std::endl;
-                                 } //
-                             });
-                opts.replaceAll(resolvedOpts);
+                const std::string &group = it->first;
+                Options &opts = it->second;
+                const Options &copts = opts; // read only, not to unshare.
+                std::vector<std::shared_ptr<Options::Option>> resolved;
+                copts.forEach([this, &group, &resolved, &optMap](const std::string &key, const Options::Option *optPtr)
+                              {
+                                  const Options::Option &opt = *optPtr;
+                                  std::unordered_set<std::string> processedFKeys;
+                                  if (opt.isType<Options::Ref>())
+                                  {
+                                      const Options::Ref &refV = opt.getValueRef<Options::Ref>();
+                                      const Options::Option &opt2 = resolveRef(optMap, refV.group, refV.key, processedFKeys);
+                                      std::shared_ptr<Options::Option> opt3 = std::make_shared<Options::Option>(opt2);
+                                      opt3->name = key;
+                                      resolved.push_back(std::move(opt3));
+                                      //std::cout << "Resolved ref option: [" << group << "] " << key << " -> " << refV.group << "." << refV.key << std::endl;
+                                  } //
+                              });
+                for (std::shared_ptr<Options::Option> &opt : resolved)
+                {
+                    opts.set(std::move(opt));
+                }
             }
         }
 
     private:
-        Options::Option &resolveRef(std::unordered_map<std::string, Options> &optMap, std::string group, std::string key, std::unordered_set<std::string> &processedFKeys)
+        const Options::Option &resolveRef(const std::unordered_map<std::string, Options> &optMap, const std::string &group, const std::string &key, std::unordered_set<std::string> &processedFKeys)
         {
             std::string fkey = group + "." + key;
             if (processedFKeys.find(fkey) != processedFKeys.end())
@@ -65,15 +71,15 @@ namespace fog
             processedFKeys.insert(fkey);
             if (auto it = optMap.find(group); it != optMap.end())
             {
-                Options &opts = it->second;
-                Options::Option *optPtr = opts.getOption(key);
+                const Options &opts = it->second;
+                const Options::Option *optPtr = opts.getOption(Options::Key(key));
                 if (!optPtr)
                 {
                     throw std::runtime_error("cannot resolve ref:" + fkey);
                 }
                 if (optPtr->isType<Options::Ref>())
                 {
-                    Options::Ref &refV = optPtr->getValueRef<Options::Ref>();
+                    const Options::Ref &refV = optPtr->getValueRef<Options::Ref>();
                     return resolveRef(optMap, refV.group, refV.key, processedFKeys);
                 }
                 else
@@ -102,26 +108,31 @@ namespace fog
             {
                 throw std::runtime_error(std::string("no such file:" + file));
             }
-            std::ifstream f(fpath);
+            MappedFile mapped(file);
+            parse(mapped.view(), optMap, strict);
+        }
 
-            if (!f.is_open())
-            {
-                throw std::runtime_error("failed to open file for read: " + file);
-            }
-            std::string line;
+        // tokenized in place, only the names, groups and string values are copied.
+        void parse(std::string_view text, std::unordered_map<std::string, Options> &optMap, bool strict)
+        {
             int lNum = 0;
             std::string group;
-            while (std::getline(f, line))
+            Options *opts = nullptr; // of the group.
+            while (!text.empty())
             {
+                auto nl = text.find('\n');
+                std::string_view line = text.substr(0, nl);
+                text.remove_prefix(nl == std::string_view::npos ? text.size() : nl + 1);
                 lNum++;
 
-                // skip space
-                while (!line.empty() && line[0] == ' ')
+                if (!line.empty() && line.back() == '\r')
                 {
-                    line = line.substr(1);
+                    line.remove_suffix(1);
                 }
+                // skip space
+                line.remove_prefix(std::min(line.find_first_not_of(' '), line.size()));
 
-                if (line.empty() || line[0] == '#' || line[0] == '/' && line.length() > 1 && line[1] == '/')
+                if (line.empty() || line[0] == '#' || line.substr(0, 2) == "//")
                 {
                     continue;
                 }
@@ -130,157 +141,190 @@ namespace fog
                 {
                     // process group
                     auto b2 = line.find(']');
-                    if (b2 == std::string::npos)
+                    if (b2 == std::string_view::npos)
                     {
                         throw std::runtime_error("group format error.");
                     }
-                    group = line.substr(1, b2 - 1);
+                    group.assign(line.substr(1, b2 - 1));
+                    opts = nullptr;
                     continue;
                 }
 
-                Options &opts = optMap[group];
+                if (!opts)
+                {
+                    opts = &optMap[group];
+                }
 
                 auto eq = line.find('=');
-                if (eq == std::string::npos)
+                if (eq == std::string_view::npos)
                 {
                     // ignore
                     continue;
                 }
-                std::string type = "string";
+                std::string_view type = "string";
 
-                auto typeLeft = line.find("<");
-                std::string key = line.substr(0, eq);
-                std::string value = line.substr(eq + 1);
-                if (typeLeft != std::string::npos)
+                auto typeLeft = line.find('<');
+                std::string_view key = line.substr(0, eq);
+                std::string_view value = line.substr(eq + 1);
+                if (typeLeft != std::string_view::npos)
                 {
                     bool typeInV = (eq < typeLeft);
                     if (typeInV)
                     {
                         typeLeft = typeLeft - eq - 1;
                     }
-                    auto typeRight = (typeInV ? value : key).find_last_of(">");
+                    std::string_view typed = typeInV ? value : key;
+                    auto typeRight = typed.find_last_of('>');
 
-                    if (typeRight == std::string::npos)
+                    if (typeRight == std::string_view::npos || typeRight < typeLeft)
                     {
                         throw std::runtime_error(std::string("config format error for lineNum:") + std::to_string(lNum));
                     }
 
+                    type = typed.substr(typeLeft + 1, typeRight - typeLeft - 1);
                     if (typeInV)
                     {
-                        type = value.substr(typeLeft + 1, typeRight - typeLeft - 1);
                         value = value.substr(typeRight + 1);
                     }
                     else
                     {
-                        type = key.substr(typeLeft + 1, typeRight - typeLeft - 1);
                         key = key.substr(0, typeLeft);
                     }
                 }
 
+                Options::Key okey(key);
                 bool ok;
                 if (type == "string")
                 {
-                    ok = opts.tryAdd<std::string>(key, value);
+                    ok = opts->tryEmplace<std::string>(okey, std::string(value));
                 }
                 else if (type == "float")
                 {
-                    ok = opts.tryAdd<float>(key, std::stof(value));
+                    ok = opts->tryEmplace<float>(okey, parseNumber<float>(value, lNum));
                 }
                 else if (type == "int")
                 {
-                    ok = opts.tryAdd<int>(key, std::stoi(value));
+                    ok = opts->tryEmplace<int>(okey, parseNumber<int>(value, lNum));
                 }
                 else if (type == "bool")
                 {
-                    ok = opts.tryAdd<bool>(key, (value == "true" || value == "yes" || value == "Y" || value == "1"));
+                    ok = opts->tryEmplace<bool>(okey, (value == "true" || value == "yes" || value == "Y" || value == "1"));
                 }
                 else if (type == "range2<int>")
                 {
-                    Range2<int> v = parseValueOfRange2Int(value);
-                    ok = opts.tryAdd<Range2<int>>(key, v);
+                    ok = opts->tryEmplace<Range2<int>>(okey, parseValueOfRange2Int(value, lNum));
                 }
                 else if (type == "unsigned int")
                 {
-                    ok = opts.tryAdd<unsigned int>(key, static_cast<unsigned int>(std::stoul(value)));
+                    ok = opts->tryEmplace<unsigned int>(okey, parseNumber<unsigned int>(value, lNum));
                 }
                 else if (type == "ref")
                 {
-                    auto point = value.find_first_of('.');
-                    std::string group;
-                    std::string key2 = value;
-                    if (point != std::string::npos)
+                    auto point = value.find('.');
+                    std::string_view group2;
+                    std::string_view key2 = value;
+                    if (point != std::string_view::npos)
                     {
-                        group = value.substr(0, point);
+                        group2 = value.substr(0, point);
                         key2 = value.substr(point + 1);
                     }
 
-                    ok = opts.tryAdd<Options::Ref>(key, Options::Ref(group, key2));
+                    ok = opts->tryEmplace<Options::Ref>(okey, Options::Ref(std::string(group2), std::string(key2)));
                 }
                 else
                 {
-                    throw std::runtime_error(std::string("not supported type:") + type);
+                    throw std::runtime_error(std::string("not supported type:") + std::string(type));
                 }
                 if (!ok && strict)
                 {
-                    throw std::runtime_error(std::string("options loading is in strict mode and item already exists:") + key);
-                }
-                if (ok)
-                {
-                    //std::cout << "Loaded option: [" << group << "] " << key << "=" << "<" << type << ">" << value << std::endl;
+                    throw std::runtime_error(std::string("options loading is in strict mode and item already exists:") + std::string(key));
                 }
 
             } // end while.
 
         } // end load
     private:
-        Range2<int> parseValueOfRange2Int(std::string string)
+        // leading spaces and a plus sign are skipped, parsing stops at the first invalid char. As with
+        // std::stoul and std::stof, a negative unsigned wraps around and a float may be in hex(0x1p3).
+        template <typename N>
+        static N parseNumber(std::string_view str, int lNum)
         {
-            std::vector<int> xyxy;
-            int p1 = 0;
-            std::string str = string;
-            while (str.length() > 0)
+            std::size_t i = 0;
+            while (i < str.size() && (str[i] == ' ' || str[i] == '\t'))
+            {
+                i++;
+            }
+            bool negative = false;
+            if (i < str.size() && (str[i] == '+' || (str[i] == '-' && !std::is_signed_v<N>)))
+            {
+                negative = str[i] == '-';
+                i++;
+            }
+            const char *first = str.data() + i;
+            const char *last = str.data() + str.size();
+            N v{};
+            std::from_chars_result ret;
+            if constexpr (std::is_floating_point_v<N>)
             {
-                std::string vS;
-                if (xyxy.size() < 3)
+                bool signedHex = first != last && *first == '-';
+                const char *hex = first + (signedHex ? 1 : 0);
+                if (last - hex > 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X'))
                 {
-
-                    auto p2 = str.find_first_of(",");
-
-                    if (p2 == std::string::npos)
-                    {
-                        vS = str;
-                        str = ""; // empty string left
-                    }
-                    else
-                    {
-                        vS = str.substr(0, p2);
-                        str = str.substr(p2 + 1, str.length() - p2 - 1);
-                    }
+                    ret = std::from_chars(hex + 2, last, v, std::chars_format::hex);
+                    v = signedHex ? -v : v;
                 }
                 else
                 {
-                    vS = str;
-                    str = ""; // empty string left
+                    ret = std::from_chars(first, last, v);
+                }
+            }
+            else
+            {
+                ret = std::from_chars(first, last, v);
+                v = negative ? static_cast<N>(N{} - v) : v;
+            }
+            if (ret.ec != std::errc())
+            {
+                throw std::runtime_error(std::string("config format error for lineNum:") + std::to_string(lNum));
+            }
+            return v;
+        }
+
+        Range2<int> parseValueOfRange2Int(std::string_view str, int lNum)
+        {
+            int xyxy[4];
+            std::size_t n = 0;
+            while (str.length() > 0)
+            {
+                std::string_view vS = str;
+                str = std::string_view(); // the last value takes the rest.
+                if (n < 3)
+                {
+                    auto p2 = vS.find(',');
+                    if (p2 != std::string_view::npos)
+                    {
+                        str = vS.substr(p2 + 1);
+                        vS = vS.substr(0, p2);
+                    }
                 }
 
-                int v = std::stoi(vS);
-                xyxy.push_back(v);
+                xyxy[n++] = parseNumber<int>(vS, lNum);
             }
 
-            if (xyxy.size() == 1)
+            if (n == 1)
             {
                 return Range2<int>(xyxy[0]);
             }
-            if (xyxy.size() == 2)
+            if (n == 2)
             {
                 return Range2<int>(xyxy[0], xyxy[1]);
             }
 
-            if (xyxy.size() == 3)
+            if (n == 3)
             {
                 return Range2<int>(xyxy[0], xyxy[1], xyxy[2], xyxy[2]);
             }
-            if (xyxy.size() == 4)
+            if (n == 4)
             {
                 return Range2<int>(xyxy[0], xyxy[1], xyxy[2], xyxy[3]);
             }
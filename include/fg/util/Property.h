@@ -14,6 +14,7 @@ namespace fog
     public:
         struct LaterBind
         {
+            std::string name;
             std::any ptr;
 
             template <typename T>
@@ -171,17 +172,18 @@ namespace fog
         class Bag
         {
             Options options;
-            std::unordered_map<std::string, std::shared_ptr<LaterBind>> laterBinds;
+            // the key of an entry is a view of the name of its later bind.
+            std::unordered_map<Options::Key, std::shared_ptr<LaterBind>, Options::Key::Hash> laterBinds;
 
         public:
             template <typename T>
-            Property::Ref<T> createProperty(std::string name, T defaultValue)
+            Property::Ref<T> createProperty(Options::Key name, T defaultValue)
             {
                 return createProperty<T>(name, defaultValue, false);
             }
 
             template <typename T>
-            Property::Ref<T> createProperty(std::string name, T defaultValue, bool allowLater)
+            Property::Ref<T> createProperty(Options::Key name, T defaultValue, bool allowLater)
             {
 
                 Options::Option *opt = options.tryAdd<T>(name, defaultValue);
@@ -189,7 +191,7 @@ namespace fog
                 {
                     if (!allowLater)
                     {
-                        throw std::runtime_error("cannot create property ref with name:" + name);
+                        throw std::runtime_error("cannot create property ref with name:" + std::string(name.name));
                     }
                     return makeLater<T>(name);
                     //
@@ -203,21 +205,22 @@ namespace fog
                     {
                         T* ptr = &opt->getValueRef<T>();
 
-                        laterBinds[name]->setPtr<T>(ptr);
-                        laterBinds.erase(name); // release the later bind.
+                        it->second->setPtr<T>(ptr);
+                        laterBinds.erase(it); // release the later bind.
                     }
 
                     return Property::Ref<T>(opt->getValueRef<T>()); // bind this ref for now, no need to bind later.
                 }
             }
             template <typename T>
-            Property::Ref<T> makeLater(std::string name)
+            Property::Ref<T> makeLater(Options::Key name)
             {
                 auto it = laterBinds.find(name);
                 if (it == laterBinds.end())
                 {
                     auto later = std::make_shared<LaterBind>();
-                    laterBinds[name] = later;
+                    later->name = name.name;
+                    laterBinds.emplace(Options::Key(later->name, name.hash), later);
                     // empty and later bind.
                     return Property::Ref<T>(later);
                 }
@@ -228,7 +231,7 @@ namespace fog
             }
 
             template <typename T>
-            Property::Ref<T> getProperty(std::string name, bool requiredNow = true)
+            Property::Ref<T> getProperty(Options::Key name, bool requiredNow = true)
             {
                 Options::Option *opt = options.getOption(name);
                 if (opt)
@@ -240,7 +243,7 @@ namespace fog
                 {
                     if (requiredNow)
                     {
-                        throw std::runtime_error("property ref not exists by name:" + name);
+                        throw std::runtime_error("property ref not exists by name:" + std::string(name.name));
                     }
 
                     return makeLater<T>(name);
@@ -251,6 +254,12 @@ namespace fog
             {
                 options.forEach(std::forward<F>(func));
             }
+
+            template <typename F>
+            void forEach(F &&func) const
+            {
+                options.forEach(std::forward<F>(func));
+            }
         };
     };
 }; //
@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#pragma once
+#include "Common.h"
+
+namespace fog
+{
+    /**
+     * Typed handle of a binding, the component and the interface cast are resolved once when the
+     * provider is created.
+     *
+     * For static usage the provider holds the resolved instance and get() is a pointer load, for
+     * dynamic usage it holds a typed factory function with the injector scope and the component,
+     * get() creates a new instance without any std::function or std::any in between. The
+     * injector must outlive a dynamic provider.
+     *
+     * A Provider<T> can be declared as argument of an INJECT constructor, it provides what the
+     * binding is scoped to: instances from the pool of a pooled binding, otherwise the static
+     * instance(the singleton of a bound impl).
+     */
+    template <typename T>
+    struct Provider
+    {
+        using Factory = T *(*)(void *ij, const void *ctx);
+
+        Provider() = default;
+
+        explicit Provider(T *ptr) : ptr(ptr)
+        {
+        }
+
+        Provider(Factory factory, void *ij, const void *ctx) : factory(factory), ij(ij), ctx(ctx)
+        {
+        }
+
+        T *get() const
+        {
+            if (!factory)
+            {
+                return ptr;
+            }
+            return factory(ij, ctx);
+        }
+
+        T *operator->() const
+        {
+            return get();
+        }
+
+        T &operator*() const
+        {
+            return *get();
+        }
+
+        bool isDynamic() const
+        {
+            return factory != nullptr;
+        }
+
+    private:
+        T *ptr = nullptr;
+        Factory factory = nullptr;
+        void *ij = nullptr;       // the injector scope creating the instances.
+        const void *ctx = nullptr; // the component, or its typed cast func.
+    };
+
+    template <typename T>
+    struct isProvider : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct isProvider<Provider<T>> : std::true_type
+    {
+    };
+};
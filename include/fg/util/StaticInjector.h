@@ -0,0 +1,491 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#pragma once
+#include "Component.h"
+#include <optional>
+#include <utility>
+
+namespace fog
+{
+    /**
+     * Compile time binding of the type T to the impl Imp, a plain type in the binding list of
+     * StaticInjector is the same as StaticBind<T, T>.
+     */
+    template <typename T, typename Imp = T>
+    struct StaticBind
+    {
+        static_assert(std::is_base_of_v<T, Imp> || std::is_same_v<T, Imp>, "impl must be derived from the bound type.");
+        static_assert(!std::is_abstract_v<Imp>, "impl of a static binding must be concrete.");
+        using Type = T;
+        using Impl = Imp;
+    };
+
+    template <typename B>
+    struct StaticBinding : StaticBind<B>
+    {
+    };
+
+    template <typename T, typename Imp>
+    struct StaticBinding<StaticBind<T, Imp>> : StaticBind<T, Imp>
+    {
+    };
+
+    // tuple of the types Ts without duplicates, in order of their first appearance.
+    template <typename Done, typename... Ts>
+    struct UniqueTypes
+    {
+        using type = Done;
+    };
+
+    template <typename... Ds, typename T, typename... Ts>
+    struct UniqueTypes<std::tuple<Ds...>, T, Ts...>
+        : UniqueTypes<std::conditional_t<(std::is_same_v<T, Ds> || ...), std::tuple<Ds...>, std::tuple<Ds..., T>>, Ts...>
+    {
+    };
+
+    template <typename Tuple>
+    struct OptionalSlots;
+
+    template <typename... Ts>
+    struct OptionalSlots<std::tuple<Ts...>>
+    {
+        using type = std::tuple<std::optional<Ts>...>;
+    };
+
+    /**
+     * Injector wired at compile time, for bindings that never change at runtime.
+     *
+     * Every impl is a singleton stored as a direct member, shared by all the types bound to it
+     * as the runtime Injector does. All of them are created in the constructor(dependencies
+     * first) from the same component classes as the runtime Injector: the INJECT constructor
+     * arguments(pointer, reference, value, Provider, Lazy or shared_ptr), the registered
+     * members(bound components, options of the group or default values) and INIT methods.
+     * INIT_ASYNC methods are called right after the INIT methods, since there is no worker pool.
+     * Instances are destroyed in the reverse order of creation.
+     *
+     * get<T>() is a member access known at compile time, no type erasure is involved, getting an
+     * unbound type is a compile error. The members of a FIELDS table are resolved by their type
+     * at compile time too, the members registered by the MEMBER macros are only known at static
+     * init time, so they are resolved through a table of the bindings by type.
+     */
+    template <typename... Bindings>
+    struct StaticInjector
+    {
+        static constexpr std::size_t N = sizeof...(Bindings);
+
+        template <typename T>
+        static constexpr std::size_t indexOf()
+        {
+            constexpr bool matches[] = {std::is_same_v<T, typename StaticBinding<Bindings>::Type>..., false};
+            for (std::size_t i = 0; i < N; i++)
+            {
+                if (matches[i])
+                {
+                    return i;
+                }
+            }
+            return N;
+        }
+
+        template <typename T>
+        static constexpr bool has()
+        {
+            return indexOf<T>() < N;
+        }
+
+        explicit StaticInjector(Options::Groups *groups = nullptr) : groups(groups)
+        {
+            try
+            {
+                createAll(std::index_sequence_for<Bindings...>{});
+            }
+            catch (...)
+            {
+                destroyAll();
+                throw;
+            }
+        }
+
+        ~StaticInjector()
+        {
+            destroyAll();
+        }
+
+        StaticInjector(const StaticInjector &) = delete;
+        StaticInjector &operator=(const StaticInjector &) = delete;
+
+        template <typename T>
+        T *get()
+        {
+            constexpr std::size_t I = indexOf<T>();
+            static_assert(I < N, "type is not bound to the StaticInjector.");
+            return std::addressof(*std::get<slotOf<I>()>(slots));
+        }
+
+    private:
+        using BindingsTuple = std::tuple<StaticBinding<Bindings>...>;
+        template <std::size_t I>
+        using TypeAt = typename std::tuple_element_t<I, BindingsTuple>::Type;
+        // impls in order of their first binding, one slot for each.
+        using Impls = typename UniqueTypes<std::tuple<>, typename StaticBinding<Bindings>::Impl...>::type;
+        static constexpr std::size_t M = std::tuple_size_v<Impls>;
+        template <std::size_t S>
+        using ImplAt = std::tuple_element_t<S, Impls>;
+
+        // slot of the impl of the binding I.
+        template <std::size_t I>
+        static constexpr std::size_t slotOf()
+        {
+            return slotOfImpl<typename std::tuple_element_t<I, BindingsTuple>::Impl>(std::make_index_sequence<M>{});
+        }
+
+        template <typename Imp, std::size_t... Ss>
+        static constexpr std::size_t slotOfImpl(std::index_sequence<Ss...>)
+        {
+            constexpr bool matches[] = {std::is_same_v<Imp, ImplAt<Ss>>..., false};
+            for (std::size_t s = 0; s < M; s++)
+            {
+                if (matches[s])
+                {
+                    return s;
+                }
+            }
+            return M;
+        }
+
+        enum class Status
+        {
+            None,
+            Creating,
+            Created
+        };
+
+        // bound type and access of each binding by index, for members resolved by type at runtime.
+        struct Entry
+        {
+            const std::type_info *type;
+            void *(*ptr)(StaticInjector &);     // T * as void *, created if not yet.
+            std::any (*value)(StaticInjector &); // T * in any.
+        };
+
+        typename OptionalSlots<Impls>::type slots;
+        std::array<Status, M> status{};
+        std::array<std::size_t, M> order{}; // order of creation.
+        std::size_t created = 0;
+        Options::Groups *groups;
+
+        template <std::size_t... Is>
+        void createAll(std::index_sequence<Is...>)
+        {
+            (require<slotOf<Is>()>(), ...);
+        }
+
+        void destroyAll()
+        {
+            static constexpr auto resets = makeResets(std::make_index_sequence<M>{});
+            while (created > 0)
+            {
+                resets[order[--created]](*this);
+            }
+        }
+
+        template <std::size_t... Ss>
+        static constexpr std::array<void (*)(StaticInjector &), M> makeResets(std::index_sequence<Ss...>)
+        {
+            return {{[](StaticInjector &sij)
+                     { std::get<Ss>(sij.slots).reset(); }...}};
+        }
+
+        template <std::size_t... Is>
+        static constexpr std::array<Entry, N> makeEntries(std::index_sequence<Is...>)
+        {
+            return {{Entry{&typeid(TypeAt<Is>), //
+                           [](StaticInjector &sij) -> void *
+                           { return static_cast<TypeAt<Is> *>(sij.require<slotOf<Is>()>()); },
+                           [](StaticInjector &sij) -> std::any
+                           { return static_cast<TypeAt<Is> *>(sij.require<slotOf<Is>()>()); }}...}};
+        }
+
+        static const Entry *findEntry(const std::type_index &tid)
+        {
+            static constexpr std::array<Entry, N> entries = makeEntries(std::index_sequence_for<Bindings...>{});
+            for (const Entry &entry : entries)
+            {
+                if (std::type_index(*entry.type) == tid)
+                {
+                    return &entry;
+                }
+            }
+            return nullptr;
+        }
+
+        template <std::size_t S>
+        ImplAt<S> *require()
+        {
+            using Imp = ImplAt<S>;
+            auto &slot = std::get<S>(slots);
+            if (status[S] == Status::Created)
+            {
+                return std::addressof(*slot);
+            }
+            if (status[S] == Status::Creating)
+            {
+                throw std::runtime_error("dependency cycle detected: " + TypeIds::nameOf(typeid(Imp)));
+            }
+            status[S] = Status::Creating;
+            FOG_TRACE("create", typeid(Imp));
+            if constexpr (hasInject<Imp>::value)
+            {
+                using ArgsTuple = typename ConstructorTraits<std::add_pointer_t<typename Imp::Inject>>::ArgsTuple;
+                emplace<S>(slot, static_cast<ArgsTuple *>(nullptr), std::make_index_sequence<std::tuple_size_v<ArgsTuple>>{});
+            }
+            else
+            {
+                slot.emplace();
+            }
+            order[created++] = S;
+            status[S] = Status::Created; // members may refer to the instance itself.
+            init<Imp>(std::addressof(*slot));
+            return std::addressof(*slot);
+        }
+
+        template <std::size_t S, typename Slot, typename ArgsTuple, std::size_t... Is>
+        void emplace(Slot &slot, ArgsTuple *, std::index_sequence<Is...>)
+        {
+            FOG_TRACE("construct", typeid(ImplAt<S>));
+            slot.emplace(getAsConstructorArg<std::tuple_element_t<Is, ArgsTuple>>()...);
+        }
+
+        template <typename T>
+        T *requireByType()
+        {
+            constexpr std::size_t I = indexOf<T>();
+            static_assert(I < N, "cannot resolve component for a arg of constructor, type is not bound to the StaticInjector.");
+            return require<slotOf<I>()>();
+        }
+
+        template <typename Arg>
+        decltype(auto) getAsConstructorArg()
+        {
+            if constexpr (std::is_pointer_v<Arg>)
+            {
+                return requireByType<std::remove_pointer_t<Arg>>();
+            }
+            else if constexpr (std::is_reference_v<Arg>)
+            {
+                return static_cast<Arg>(*requireByType<std::remove_reference_t<Arg>>());
+            }
+            else if constexpr (isProvider<Arg>::value)
+            {
+                using T = std::remove_pointer_t<decltype(std::declval<Arg>().get())>;
+                return Arg(requireByType<T>());
+            }
+            else if constexpr (isLazy<Arg>::value)
+            {
+                using T = typename isLazy<Arg>::Type;
+                static_assert(has<T>(), "cannot resolve component for a lazy arg of constructor, type is not bound to the StaticInjector.");
+                return Arg([this]()
+                           { return requireByType<T>(); });
+            }
+            else if constexpr (isSharedPtr<Arg>::value)
+            {
+                return Arg(Arg(), requireByType<typename Arg::element_type>()); // not owned.
+            }
+            else
+            {
+                static_assert(!isUniquePtr<Arg>::value, "unique_ptr arg of constructor is not supported by StaticInjector.");
+                return static_cast<const Arg &>(*requireByType<Arg>()); // copied.
+            }
+        }
+
+        // registered members, INIT and INIT_ASYNC methods, same resolution as the runtime injector.
+        template <typename T>
+        void init(T *obj)
+        {
+            if constexpr (hasFields<T>::value)
+            {
+                FOG_TRACE("members", typeid(T));
+                std::apply([this, obj](const auto &...entries)
+                           { (setField(obj, entries), ...); },
+                           T::Fields);
+                FOG_TRACE("init", typeid(T));
+                std::apply([obj](const auto &...entries)
+                           { (callMethod<MethodKind::Init>(obj, entries), ...); },
+                           T::Fields);
+                std::apply([obj](const auto &...entries)
+                           { (callMethod<MethodKind::InitAsync>(obj, entries), ...); },
+                           T::Fields);
+            }
+            else
+            {
+                initRegistered(obj);
+            }
+        }
+
+        // member of the FIELDS table: the bound component of its type, the option of the group or the default value.
+        template <typename T, typename F, typename D>
+        void setField(T *obj, const Field<T, F, D> &entry)
+        {
+            using V = std::remove_pointer_t<F>;
+            if constexpr (isLazy<F>::value)
+            {
+                using X = typename isLazy<F>::Type;
+                static_assert(has<X>(), "cannot resolve the component of a lazy member, type is not bound to the StaticInjector.");
+                obj->*entry.member = F([this]()
+                                       { return requireByType<X>(); });
+            }
+            else if constexpr (has<V>())
+            {
+                if constexpr (std::is_pointer_v<F>)
+                {
+                    obj->*entry.member = requireByType<V>();
+                }
+                else
+                {
+                    obj->*entry.member = *requireByType<V>(); // copied.
+                }
+            }
+            else if (const Options::Option *opt = findOption<T, V>(entry.name, entry.key))
+            {
+                if constexpr (std::is_pointer_v<F>)
+                {
+                    obj->*entry.member = const_cast<V *>(&opt->getValueRef<V>());
+                }
+                else
+                {
+                    obj->*entry.member = opt->getValueRef<V>();
+                }
+            }
+            else
+            {
+                if constexpr (std::is_same_v<D, NoDefault>)
+                {
+                    throw std::runtime_error(std::string("connot resolve the value for member:") + entry.name + ",key:" + entry.key + (hasGroup<T>::value ? "(no default value)" : "(no function registered)"));
+                }
+                else
+                {
+                    obj->*entry.member = F(entry.dftVal);
+                }
+            }
+        }
+
+        template <typename T, MethodKind K>
+        void setField(T *, const Method<T, K> &)
+        {
+        }
+
+        template <MethodKind K, typename T, MethodKind E>
+        static void callMethod(T *obj, const Method<T, E> &entry)
+        {
+            if constexpr (K == E)
+            {
+                (obj->*entry.method)();
+            }
+        }
+
+        template <MethodKind K, typename T, typename E>
+        static void callMethod(T *, const E &)
+        {
+        }
+
+        // option of the group of T named by the key(the member name if empty), null if none.
+        template <typename T, typename V>
+        const Options::Option *findOption(std::string_view name, std::string_view key) const
+        {
+            if constexpr (hasGroup<T>::value)
+            {
+                if (!groups)
+                {
+                    return nullptr;
+                }
+                auto it = groups->groups.find(T::Group);
+                if (it == groups->groups.end())
+                {
+                    return nullptr;
+                }
+                const Options::Option *opt = std::as_const(it->second).getOption(Options::Key(key.empty() ? name : key));
+                if (opt && opt->getType() != typeid(V))
+                {
+                    throw std::runtime_error("cannot resolve option " + std::string(key.empty() ? name : key) + "(type mismatch)");
+                }
+                return opt;
+            }
+            else
+            {
+                return nullptr;
+            }
+        }
+
+        // members and methods registered by the macros, resolved by type at runtime.
+        template <typename T>
+        void initRegistered(T *obj)
+        {
+            const AutoRegisteredObjects::ObjectInfo *objPtr = AutoRegisteredObjects::find<T>();
+            if (!objPtr)
+            {
+                return;
+            }
+            const AutoRegisteredObjects::ObjectInfo &objInfo = *objPtr;
+            {
+                FOG_TRACE("members", typeid(T));
+                for (const auto &fieldPair : objInfo.members)
+                {
+                    const std::string &mebName = fieldPair.first;
+                    const AutoRegisteredObjects::MemberInfo &mebInfo = fieldPair.second;
+                    std::any value;
+                    if (mebInfo.makeLazy)
+                    {
+                        const Entry *entry = findEntry(mebInfo.lazyType);
+                        if (!entry)
+                        {
+                            throw std::runtime_error("connot resolve the component for lazy member:" + mebName);
+                        }
+                        value = mebInfo.makeLazy([this, entry]()
+                                                 { return entry->value(*this); });
+                    }
+                    else if (const Entry *entry = findEntry(mebInfo.vType))
+                    {
+                        mebInfo.assign(obj, entry->ptr(*this));
+                        continue;
+                    }
+                    else
+                    {
+                        getConfigMember<T>(mebInfo, mebName, value);
+                    }
+                    mebInfo.assign(obj, mebInfo.srcOf(value));
+                }
+            }
+            {
+                FOG_TRACE("init", typeid(T));
+                for (const auto &init : objInfo.inits)
+                {
+                    init.invoke(obj);
+                }
+                for (const auto &init : objInfo.asyncInits)
+                {
+                    init.invoke(obj);
+                }
+            }
+        }
+
+        template <typename T>
+        void getConfigMember(const AutoRegisteredObjects::MemberInfo &mebInfo, const std::string &mebName, std::any &value)
+        {
+            if constexpr (hasGroup<T>::value)
+            {
+                ConfigMembers<T> members([this]()
+                                         { return groups; }); // default values only without groups.
+                if (!members(mebInfo.vType, mebName, mebInfo.key, value, false) && !(mebInfo.defaultVal)(value))
+                {
+                    throw std::runtime_error("connot resolve the value for member:" + mebName + ",key:" + mebInfo.key + "(no default value)");
+                }
+            }
+            else if (!(mebInfo.defaultVal)(value))
+            {
+                throw std::runtime_error("connot resolve the value for member:" + mebName + ",key:" + mebInfo.key + "(no function registered)");
+            }
+        }
+    };
+};
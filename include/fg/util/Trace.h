@@ -0,0 +1,152 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#pragma once
+#include "Common.h"
+#include "TypeIds.h"
+#include <chrono>
+#include <ostream>
+#include <thread>
+
+#define FOG_TRACE_CONCAT_(a, b) a##b
+#define FOG_TRACE_CONCAT(a, b) FOG_TRACE_CONCAT_(a, b)
+
+/**
+ * Trace the enclosing scope as a phase of the component type, compiled out unless FOG_UTIL_TRACE
+ * is defined(see the cmake option of the same name).
+ */
+#if defined(FOG_UTIL_TRACE)
+#define FOG_TRACE(phase, type) ::fog::Trace::Scope FOG_TRACE_CONCAT(fogTraceScope, __LINE__)(phase, type)
+#else
+#define FOG_TRACE(phase, type)
+#endif
+
+namespace fog
+{
+    /**
+     * Recorder of the construction of components: time, nesting depth and thread of each phase.
+     * Events are buffered per thread, the whole timeline can be written as Chrome trace JSON, which
+     * is loadable by chrome://tracing and Perfetto.
+     */
+    struct Trace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct Event
+        {
+            const char *phase;
+            std::type_index type;
+            std::chrono::nanoseconds start; // since the trace epoch.
+            std::chrono::nanoseconds duration;
+            int depth;
+            std::size_t thread; // dense index of the thread.
+        };
+
+        struct Scope
+        {
+            Scope(const char *phase, std::type_index type) : trace(getInstance()), phase(phase), type(type), begin(Clock::now())
+            {
+                getDepth()++;
+            }
+
+            ~Scope()
+            {
+                Clock::time_point end = Clock::now();
+                int depth = --getDepth();
+                trace.getBuffer().events.push_back(Event{phase, type, begin - trace.epoch, end - begin, depth, trace.getBuffer().thread});
+            }
+
+        private:
+            Trace &trace;
+            const char *phase;
+            std::type_index type;
+            Clock::time_point begin;
+        };
+
+        static Trace &getInstance()
+        {
+            static Trace instance;
+            return instance;
+        }
+
+        // all events recorded so far, call it when no component is being created.
+        std::vector<Event> getEvents()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<Event> ret;
+            for (const auto &buffer : buffers)
+            {
+                ret.insert(ret.end(), buffer->events.begin(), buffer->events.end());
+            }
+            return ret;
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto &buffer : buffers)
+            {
+                buffer->events.clear();
+            }
+        }
+
+        void writeChromeTrace(std::ostream &os)
+        {
+            os << "{\"traceEvents\":[";
+            bool first = true;
+            for (const Event &event : getEvents())
+            {
+                os << (first ? "\n" : ",\n");
+                first = false;
+                os << fmt::format("{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{},\"args\":{{\"depth\":{}}}}}",
+                                  escape(TypeIds::nameOf(event.type)), event.phase, event.start.count() / 1000.0, event.duration.count() / 1000.0, event.thread, event.depth);
+            }
+            os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        }
+
+    private:
+        struct Buffer
+        {
+            std::size_t thread;
+            std::vector<Event> events;
+        };
+
+        Clock::time_point epoch = Clock::now();
+        std::mutex mutex;
+        std::vector<std::shared_ptr<Buffer>> buffers; // kept after the thread exits.
+
+        Buffer &getBuffer()
+        {
+            thread_local std::shared_ptr<Buffer> buffer = addBuffer();
+            return *buffer;
+        }
+
+        std::shared_ptr<Buffer> addBuffer()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffers.push_back(std::make_shared<Buffer>(Buffer{buffers.size(), {}}));
+            return buffers.back();
+        }
+
+        static int &getDepth()
+        {
+            thread_local int depth = 0;
+            return depth;
+        }
+
+        static std::string escape(const std::string &str)
+        {
+            std::string ret;
+            for (char c : str)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    ret += '\\';
+                }
+                ret += c;
+            }
+            return ret;
+        }
+    };
+};
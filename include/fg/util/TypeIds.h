@@ -0,0 +1,68 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#pragma once
+#include "Common.h"
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace fog
+{
+    /**
+     * Dense, process-wide integer ids of types.
+     *
+     * The id of a type is assigned the first time it is asked for and never changes afterwards.
+     * Ids start from 0 and have no gaps, so they can be used as index of a flat table. The typed
+     * version caches the id in a function-local static, asking for it again is a single load.
+     */
+    struct TypeIds
+    {
+        static std::size_t of(std::type_index tid)
+        {
+            TypeIds &typeIds = getInstance();
+            std::lock_guard<std::mutex> lock(typeIds.mutex);
+            if (auto it = typeIds.ids.find(tid); it != typeIds.ids.end())
+            {
+                return it->second;
+            }
+            std::size_t id = typeIds.ids.size();
+            typeIds.ids.emplace(tid, id);
+            return id;
+        }
+
+        template <typename T>
+        static std::size_t of()
+        {
+            static const std::size_t id = of(typeid(T));
+            return id;
+        }
+
+        /**
+         * Readable name of the type for messages, demangled if the compiler supports.
+         */
+        static std::string nameOf(std::type_index tid)
+        {
+#if defined(__GNUG__)
+            int status = 0;
+            std::unique_ptr<char, void (*)(void *)> name(abi::__cxa_demangle(tid.name(), nullptr, nullptr, &status), std::free);
+            if (status == 0 && name)
+            {
+                return name.get();
+            }
+#endif
+            return tid.name();
+        }
+
+    private:
+        std::mutex mutex;
+        std::unordered_map<std::type_index, std::size_t> ids;
+
+        static TypeIds &getInstance()
+        {
+            static TypeIds instance;
+            return instance;
+        }
+    };
+};
@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#pragma once
+#include "Common.h"
+#include "Arena.h"
+
+namespace fog
+{
+    struct Injector;
+
+    /**
+     * Registry of the wiring generated as plain C++ by fog-wiring-gen(see tools/fog_wiring_gen.cpp).
+     *
+     * For a component bound by impl, the generated create function calls the INJECT constructor
+     * directly with the arguments got from the injector, the generated inject function assigns
+     * the members bound to components and calls the INIT method directly. The injector uses the
+     * entry of the impl type when present, the members from config, lazy members and the other
+     * methods are still resolved by the compiled plan of the component.
+     */
+    struct Wiring
+    {
+        struct Entry
+        {
+            std::type_index type;                      // the impl type.
+            void *(*create)(Injector &, Arena *arena); // impl instance from the arena(heap if null), null if not generated.
+            void (*inject)(void *obj, Injector &);     // members and init.
+            std::vector<std::string> members;          // assigned by inject.
+            bool init;                                 // INIT method called by inject.
+        };
+
+        // registered by the generated translation unit at static init time.
+        struct Registrar
+        {
+            Registrar(std::initializer_list<Entry> entries)
+            {
+                Wiring &wiring = getInstance();
+                std::lock_guard<std::mutex> lock(wiring.mutex);
+                for (const Entry &entry : entries)
+                {
+                    wiring.entries.emplace(entry.type, entry);
+                }
+            }
+        };
+
+        static const Entry *find(std::type_index type)
+        {
+            Wiring &wiring = getInstance();
+            std::lock_guard<std::mutex> lock(wiring.mutex);
+            if (auto it = wiring.entries.find(type); it != wiring.entries.end())
+            {
+                return &it->second;
+            }
+            return nullptr;
+        }
+
+        template <typename T, typename... Args>
+        static T *make(Arena *arena, Args &&...args)
+        {
+            if (arena)
+            {
+                return arena->make<T>(std::forward<Args>(args)...);
+            }
+            if constexpr (sizeof...(Args) == 0)
+            {
+                return new T{};
+            }
+            else
+            {
+                return new T(std::forward<Args>(args)...);
+            }
+        }
+
+    private:
+        std::mutex mutex;
+        std::unordered_map<std::type_index, Entry> entries;
+
+        static Wiring &getInstance()
+        {
+            static Wiring instance;
+            return instance;
+        }
+    };
+};
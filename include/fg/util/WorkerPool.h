@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#pragma once
+#include "Common.h"
+#include <thread>
+#include <condition_variable>
+
+namespace fog
+{
+    /**
+     * Fixed size pool of worker threads running submitted tasks in FIFO order.
+     * A task may submit other tasks, wait() returns once the queue is drained and no task is running.
+     * An exception thrown by a task does not stop its worker, the first one is rethrown by wait().
+     */
+    struct WorkerPool
+    {
+        using Task = std::function<void()>;
+
+        explicit WorkerPool(std::size_t size = 0)
+        {
+            if (size == 0)
+            {
+                size = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+            }
+            for (std::size_t i = 0; i < size; i++)
+            {
+                threads.emplace_back([this]()
+                                     { run(); });
+            }
+        }
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            hasTask.notify_all();
+            for (std::thread &t : threads)
+            {
+                t.join();
+            }
+        }
+
+        void submit(Task task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.push(std::move(task));
+            }
+            hasTask.notify_one();
+        }
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            idle.wait(lock, [this]()
+                      { return tasks.empty() && running == 0; });
+            if (error)
+            {
+                std::exception_ptr ret;
+                std::swap(ret, error);
+                std::rethrow_exception(ret);
+            }
+        }
+
+        std::size_t size() const
+        {
+            return threads.size();
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable hasTask;
+        std::condition_variable idle;
+        std::queue<Task> tasks;
+        std::size_t running = 0;
+        bool stopping = false;
+        std::exception_ptr error; // first thrown by a task since the last wait().
+        std::vector<std::thread> threads;
+
+        void run()
+        {
+            while (true)
+            {
+                Task task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    hasTask.wait(lock, [this]()
+                                 { return stopping || !tasks.empty(); });
+                    if (tasks.empty())
+                    {
+                        return; // stopping.
+                    }
+                    task = std::move(tasks.front());
+                    tasks.pop();
+                    running++;
+                }
+                std::exception_ptr thrown;
+                try
+                {
+                    task();
+                }
+                catch (...)
+                {
+                    thrown = std::current_exception();
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    error = error ? error : thrown;
+                    running--;
+                    if (tasks.empty() && running == 0)
+                    {
+                        idle.notify_all();
+                    }
+                }
+            }
+        }
+    };
+};
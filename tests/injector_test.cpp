@@ -0,0 +1,798 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#include <fg/util/Injector.h>
+#include <fg/util/EventBus.h>
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <thread>
+
+using namespace fog;
+
+namespace
+{
+    constexpr unsigned int Dynamic = 2; // usage of a new instance per get.
+
+    struct IEngine
+    {
+        virtual ~IEngine() = default;
+        virtual int power() = 0;
+    };
+
+    struct Engine : IEngine
+    {
+        int power() override
+        {
+            return 42;
+        }
+    };
+
+    struct Car
+    {
+        SELFG(Car, "car")
+        INJECT(Car(IEngine *engine, EventBus &bus)) : engine(engine), bus(&bus)
+        {
+        }
+        IEngine *engine;
+        EventBus *bus;
+        int speed = 0;
+        MEMBERKD(speed, "speed", 7)
+        float scale = 0;
+        MEMBERD(scale, 1.5f)
+        bool inited = false;
+        INIT(init)()
+        {
+            inited = true;
+        }
+    };
+
+    void bindCar(Injector &ij, Options::Groups &groups)
+    {
+        ij.bindPtr<Options::Groups>(&groups);
+        ij.bindImpl<IEngine, Engine>();
+        ij.bindImpl<EventBus>();
+        ij.bindImpl<Car>();
+    }
+
+    template <typename F>
+    std::string errorOf(F &&func)
+    {
+        try
+        {
+            func();
+        }
+        catch (const std::exception &e)
+        {
+            return e.what();
+        }
+        return "";
+    }
+}
+
+TEST_CASE("Injector.InjectsArgumentsMembersAndInit", "[injector]")
+{
+    Injector ij;
+    Options::Groups groups;
+    groups.groups["car"].add<int>("speed", 11);
+    bindCar(ij, groups);
+
+    Car *car = ij.get<Car>();
+    CHECK(car->engine->power() == 42);
+    CHECK(car->bus == ij.get<EventBus>());
+    CHECK(car->speed == 11);
+    CHECK(car->scale == 1.5f);
+    CHECK(car->inited);
+    CHECK(ij.get<Car>() == car);
+
+    std::unique_ptr<Car> dynamic(ij.get<Car, Dynamic>());
+    CHECK(dynamic.get() != car);
+    CHECK(dynamic->engine == car->engine);
+}
+
+TEST_CASE("Injector.DefaultValueWithoutConfig", "[injector]")
+{
+    Injector ij;
+    Options::Groups groups;
+    bindCar(ij, groups);
+    CHECK(ij.get<Car>()->speed == 7);
+}
+
+namespace
+{
+    struct Plain
+    {
+        SELF(Plain)
+        int x = 0;
+        MEMBERD(x, 5)
+    };
+}
+
+TEST_CASE("Injector.DefaultValueWithoutGroup", "[injector]")
+{
+    Injector ij;
+    ij.bindImpl<Plain>();
+    CHECK_NOTHROW(ij.validate());
+    CHECK(ij.get<Plain>()->x == 5);
+    std::unique_ptr<Plain> dynamic(ij.get<Plain, Dynamic>());
+    CHECK(dynamic->x == 5);
+}
+
+TEST_CASE("Injector.BindingsOfOneImplShareTheInstance", "[injector]")
+{
+    Injector ij;
+    ij.bindImpl<IEngine, Engine>();
+    ij.bindImpl<Engine>();
+    CHECK(static_cast<IEngine *>(ij.get<Engine>()) == ij.get<IEngine>());
+
+    struct OtherEngine : IEngine
+    {
+        int power() override
+        {
+            return 1;
+        }
+    };
+    CHECK_THROWS_AS((ij.bindImpl<IEngine, OtherEngine>()), std::runtime_error);
+    CHECK(ij.get<IEngine>()->power() == 42);
+}
+
+TEST_CASE("Injector.FrozenGetFromThreads", "[injector]")
+{
+    Injector ij;
+    Options::Groups groups;
+    bindCar(ij, groups);
+    ij.freeze();
+    CHECK_THROWS_AS(ij.bindImpl<Engine>(), std::runtime_error);
+
+    std::vector<Car *> cars(8);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < cars.size(); i++)
+    {
+        threads.emplace_back([&ij, &cars, i]()
+                             { cars[i] = ij.get<Car>(); });
+    }
+    for (std::thread &t : threads)
+    {
+        t.join();
+    }
+    for (Car *car : cars)
+    {
+        CHECK(car == cars[0]);
+    }
+}
+
+namespace
+{
+    struct Garage
+    {
+        INJECT(Garage(Provider<IEngine> engines, Provider<Car> cars)) : engines(engines), cars(cars)
+        {
+        }
+        Provider<IEngine> engines;
+        Provider<Car> cars;
+    };
+}
+
+TEST_CASE("Injector.ProviderHonorsTheBindingScope", "[injector]")
+{
+    Injector ij;
+    Options::Groups groups;
+    bindCar(ij, groups);
+    ij.bindImpl<Garage>();
+
+    Garage *garage = ij.get<Garage>();
+    CHECK_FALSE(garage->engines.isDynamic());
+    CHECK(garage->engines.get() == ij.get<IEngine>());
+    CHECK(garage->cars.get() == ij.get<Car>());
+
+    Provider<Car> cars = ij.getProvider<Car, Dynamic>();
+    std::unique_ptr<Car> a(cars.get());
+    std::unique_ptr<Car> b(cars.get());
+    CHECK(a.get() != b.get());
+    CHECK(ij.getProvider<Options::Groups>().get() == &groups);
+}
+
+namespace
+{
+    int heavyMade = 0;
+
+    struct Heavy
+    {
+        Heavy()
+        {
+            heavyMade++;
+        }
+        int v = 9;
+    };
+
+    struct Tool
+    {
+        SELF(Tool)
+        INJECT(Tool(Lazy<Heavy> heavy)) : heavy(heavy)
+        {
+        }
+        Lazy<Heavy> heavy;
+        Lazy<Heavy> member;
+        MEMBERK(member, "member")
+    };
+}
+
+TEST_CASE("Injector.LazyResolvesOnFirstUse", "[injector]")
+{
+    Injector ij;
+    ij.bindImpl<Heavy>();
+    ij.bindImpl<Tool>();
+    ij.validate();
+
+    heavyMade = 0;
+    Tool *tool = ij.get<Tool>();
+    CHECK(heavyMade == 0);
+    CHECK(tool->heavy->v == 9);
+    CHECK(heavyMade == 1);
+    CHECK(tool->member.get() == tool->heavy.get());
+
+    Lazy<Heavy> empty;
+    CHECK_THROWS_AS(empty.get(), std::runtime_error);
+}
+
+namespace
+{
+    int alive = 0;
+
+    struct Counted
+    {
+        Counted()
+        {
+            alive++;
+        }
+        ~Counted()
+        {
+            alive--;
+        }
+    };
+
+    struct Request
+    {
+        SELF(Request)
+        INJECT(Request(IEngine *engine)) : engine(engine)
+        {
+            alive++;
+        }
+        ~Request()
+        {
+            alive--;
+        }
+        IEngine *engine;
+        Car *car = nullptr;
+        MEMBERK(car, "car")
+    };
+
+    struct Part
+    {
+        virtual ~Part() = default;
+        virtual int id() = 0;
+    };
+
+    struct PartA : Part
+    {
+        int id() override
+        {
+            return 1;
+        }
+    };
+
+    struct PartB : Part
+    {
+        int id() override
+        {
+            return 2;
+        }
+    };
+
+    struct Holder
+    {
+        SELF(Holder)
+        INJECT(Holder(Part *arg)) : arg(arg)
+        {
+        }
+        Part *arg;
+        Part *member = nullptr;
+        MEMBERK(member, "member")
+    };
+}
+
+TEST_CASE("Injector.ChildScopeReleasesItsArena", "[injector]")
+{
+    Injector parent;
+    Options::Groups groups;
+    bindCar(parent, groups);
+    parent.bindImpl<Counted>();
+    parent.freeze();
+    alive = 0;
+    {
+        Injector scope(&parent);
+        scope.bindImpl<Request>();
+        Request *req = scope.get<Request>();
+        for (int i = 0; i < 10; i++)
+        {
+            scope.get<Counted, Dynamic>(); // owned by the arena.
+        }
+        CHECK(alive == 11);
+        CHECK(req->engine == parent.get<IEngine>());
+        CHECK(req->car == parent.get<Car>());
+        CHECK(scope.get<Request>() == req);
+    }
+    CHECK(alive == 0);
+}
+
+TEST_CASE("Injector.ChildScopeOverridesParentBindings", "[injector]")
+{
+    Injector parent;
+    parent.bindImpl<Part, PartA>();
+    parent.bindImpl<Holder>();
+    std::unique_ptr<Holder> fromParent(parent.get<Holder, Dynamic>());
+    CHECK(fromParent->arg->id() == 1);
+    CHECK(fromParent->member->id() == 1);
+
+    Injector scope(&parent);
+    scope.bindImpl<Part, PartB>();
+    Holder *h = scope.get<Holder, Dynamic>();
+    CHECK(h->arg->id() == 2);
+    CHECK(h->member->id() == 2);
+    std::unique_ptr<Holder> again(parent.get<Holder, Dynamic>());
+    CHECK(again->member->id() == 1);
+}
+
+namespace
+{
+    struct Bullet
+    {
+        SELF(Bullet)
+        INJECT(Bullet(IEngine *engine)) : engine(engine)
+        {
+        }
+        IEngine *engine;
+        int hp = 0;
+        int inits = 0;
+        INIT(init)()
+        {
+            inits++;
+            hp = 10;
+        }
+        RESET(reset)()
+        {
+            hp = 10;
+        }
+    };
+
+    struct Gun
+    {
+        INJECT(Gun(Provider<Bullet> bullets)) : bullets(bullets)
+        {
+        }
+        Provider<Bullet> bullets;
+    };
+}
+
+TEST_CASE("Injector.PooledInstancesAreReset", "[injector]")
+{
+    Injector ij;
+    ij.bindImpl<IEngine, Engine>();
+    ij.bindPooled<Bullet>(2);
+    ij.bindImpl<Gun>();
+
+    Gun *gun = ij.get<Gun>();
+    CHECK(gun->bullets.isDynamic());
+    Bullet *a = gun->bullets.get();
+    Bullet *b = ij.get<Bullet, Dynamic>();
+    Bullet *c = ij.get<Bullet, Dynamic>();
+    a->hp = 1;
+    ij.release(a);
+    ij.release(b);
+    ij.release(c); // over the limit, deleted.
+
+    Bullet *d = ij.get<Bullet, Dynamic>();
+    CHECK((d == a || d == b));
+    CHECK(d->hp == 10);
+    CHECK(d->inits == 1);
+    PoolStats stats = ij.getPoolStats<Bullet>();
+    CHECK(stats.hits == 1u);
+    CHECK(stats.misses == 3u);
+    CHECK(stats.releases == 2u);
+    CHECK(stats.drops == 1u);
+    CHECK(stats.idle == 1u);
+    ij.release(d);
+
+    CHECK_THROWS_AS(ij.getPoolStats<IEngine>(), std::runtime_error);
+}
+
+namespace
+{
+    struct Mob
+    {
+        SELFG(Mob, "car")
+        INJECT(Mob(IEngine *engine)) : engine(engine)
+        {
+        }
+        IEngine *engine;
+        int speed = 0;
+        MEMBERK(speed, "speed")
+        int n = 0;
+        INIT(init)()
+        {
+            n = 5;
+        }
+    };
+}
+
+TEST_CASE("Injector.CreateManyIsContiguous", "[injector]")
+{
+    Injector ij;
+    Options::Groups groups;
+    groups.groups["car"].add<int>("speed", 33);
+    ij.bindPtr<Options::Groups>(&groups);
+    ij.bindImpl<IEngine, Engine>();
+    ij.bindImpl<Mob>();
+
+    Batch<Mob> mobs = ij.createMany<Mob>(1000, 4);
+    REQUIRE(mobs.size() == 1000u);
+    CHECK(reinterpret_cast<char *>(&mobs[1]) - reinterpret_cast<char *>(&mobs[0]) == static_cast<std::ptrdiff_t>(sizeof(Mob)));
+    for (Mob &mob : mobs)
+    {
+        CHECK(mob.speed == 33);
+        CHECK(mob.n == 5);
+        CHECK(mob.engine == ij.get<IEngine>());
+    }
+    CHECK(ij.createMany<Mob>(0).empty());
+    CHECK_THROWS_AS(Batch<Mob>::allocate(SIZE_MAX / 2), std::bad_array_new_length);
+    CHECK_THROWS_AS(ij.createMany<Engine>(1), std::runtime_error);
+}
+
+namespace
+{
+    struct Assets
+    {
+        SELF(Assets)
+        std::atomic<bool> loaded{false};
+        INIT_ASYNC(load)()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            loaded = true;
+        }
+    };
+
+    struct Flaky
+    {
+        SELF(Flaky)
+        INIT_ASYNC(load)()
+        {
+            throw std::runtime_error("flaky");
+        }
+    };
+}
+
+TEST_CASE("Injector.AsyncInitCompletesBeforeTheFuture", "[injector]")
+{
+    Injector ij;
+    ij.bindImpl<Assets>();
+    std::shared_future<Assets *> assets = ij.getAsync<Assets>();
+    CHECK(assets.get()->loaded);
+
+    std::unique_ptr<Assets> dynamic(ij.get<Assets, Dynamic>());
+    ij.waitReady(); // dynamic instances are waited by the barrier only.
+    CHECK(dynamic->loaded);
+}
+
+TEST_CASE("Injector.AsyncInitFailureIsRethrown", "[injector]")
+{
+    Injector ij;
+    ij.bindImpl<Flaky>();
+    std::shared_future<Flaky *> flaky = ij.getAsync<Flaky>();
+    CHECK_THROWS_AS(flaky.get(), std::runtime_error);
+    CHECK_THROWS_AS(ij.waitReady(), std::runtime_error);
+}
+
+TEST_CASE("Injector.CreateManyWaitsForAsyncInit", "[injector]")
+{
+    Injector ij;
+    ij.bindImpl<Assets>();
+    ij.bindImpl<Flaky>();
+    Batch<Assets> assets = ij.createMany<Assets>(8, 2);
+    for (Assets &a : assets)
+    {
+        CHECK(a.loaded);
+    }
+    CHECK_THROWS_AS(ij.createMany<Flaky>(4), std::runtime_error);
+    CHECK_THROWS_AS(ij.waitReady(), std::runtime_error);
+
+    ij.bindPooled<Bullet>(2);
+    CHECK_THROWS_AS(ij.createMany<Bullet>(1), std::runtime_error);
+}
+
+namespace
+{
+    struct CycleB;
+    struct CycleA
+    {
+        INJECT(CycleA(CycleB *))
+        {
+        }
+    };
+    struct CycleB
+    {
+        INJECT(CycleB(CycleA *))
+        {
+        }
+    };
+
+    struct Missing
+    {
+        SELFG(Missing, "missing")
+        INJECT(Missing(Heavy *))
+        {
+        }
+        int q = 0;
+        MEMBERK(q, "q")
+    };
+}
+
+TEST_CASE("Injector.ValidateReportsCyclesAndMissingBindings", "[injector]")
+{
+    Injector ij;
+    Options::Groups groups;
+    ij.bindPtr<Options::Groups>(&groups);
+    ij.bindImpl<CycleA>();
+    ij.bindImpl<CycleB>();
+    ij.bindImpl<Missing>();
+
+    std::string a = TypeIds::nameOf(typeid(CycleA));
+    std::string b = TypeIds::nameOf(typeid(CycleB));
+    std::string missing = TypeIds::nameOf(typeid(Missing));
+    std::string error = errorOf([&ij]()
+                                { ij.validate(); });
+    INFO(error);
+    CHECK(error.find(missing + ": no component bound for arg 0 of constructor") != std::string::npos);
+    CHECK(error.find(missing + ": cannot resolve the value for member:q") != std::string::npos);
+    CHECK((error.find("dependency cycle: " + a + " -> " + b + " -> " + a) != std::string::npos ||
+           error.find("dependency cycle: " + b + " -> " + a + " -> " + b) != std::string::npos));
+
+    error = errorOf([&ij]()
+                    { ij.get<CycleA>(); });
+    INFO(error);
+    CHECK(error.find("dependency cycle detected: " + a + " -> " + b + " -> " + a) != std::string::npos);
+}
+
+TEST_CASE("Injector.WarmUpCreatesAllInDependencyOrder", "[injector]")
+{
+    Injector ij;
+    Options::Groups groups;
+    bindCar(ij, groups);
+    ij.bindImpl<Garage>();
+
+    Injector::WarmUpReport report = ij.warmUp(2);
+    REQUIRE(report.entries.size() == 4u);
+    auto position = [&report](std::type_index type)
+    {
+        for (std::size_t i = 0; i < report.entries.size(); i++)
+        {
+            if (report.entries[i].type == type)
+            {
+                return i;
+            }
+        }
+        return report.entries.size();
+    };
+    CHECK(position(typeid(IEngine)) < position(typeid(Car)));
+    CHECK(position(typeid(EventBus)) < position(typeid(Car)));
+    CHECK(ij.isFrozen());
+}
+
+namespace
+{
+    struct Settings
+    {
+        int port = 0;
+    };
+
+    struct Server
+    {
+        INJECT(Server(Settings settings, std::unique_ptr<Counted> owned, std::shared_ptr<Counted> shared))
+            : settings(settings), owned(std::move(owned)), shared(shared)
+        {
+        }
+        Settings settings;
+        std::unique_ptr<Counted> owned;
+        std::shared_ptr<Counted> shared;
+    };
+}
+
+TEST_CASE("Injector.ValueUniqueAndSharedArguments", "[injector]")
+{
+    static Settings settings{8080};
+    Injector ij;
+    ij.bindArgOfConstructor<Settings, Server>([]() -> std::any
+                                              { return &settings; });
+    ij.bindImpl<Counted>();
+    ij.bindImpl<Server>();
+    ij.validate();
+    alive = 0;
+    {
+        std::unique_ptr<Server> a(ij.get<Server, Dynamic>());
+        std::unique_ptr<Server> b(ij.get<Server, Dynamic>());
+        CHECK(a->settings.port == 8080);
+        CHECK(a->owned != b->owned);
+        CHECK(a->shared == b->shared);
+        CHECK(alive == 3);
+    }
+    CHECK(alive == 0);
+}
+
+namespace
+{
+    std::vector<std::string> teardown;
+
+    struct First
+    {
+        SELF(First)
+        ~First()
+        {
+            teardown.push_back("~First");
+        }
+        DESTROY(close)()
+        {
+            teardown.push_back("closeFirst");
+        }
+    };
+
+    struct Second
+    {
+        SELF(Second)
+        INJECT(Second(First *))
+        {
+        }
+        ~Second()
+        {
+            teardown.push_back("~Second");
+        }
+        void close()
+        {
+            teardown.push_back("closeSecond");
+        }
+        FIELDS(ON_DESTROY(close))
+    };
+}
+
+TEST_CASE("Injector.ShutdownDestroysInReverseOrder", "[injector]")
+{
+    teardown.clear();
+    {
+        Injector ij;
+        ij.bindImpl<First>();
+        ij.bindImpl<Second>();
+        ij.get<Second>();
+        CHECK(ij.getLiveStats().objects == 2u);
+        ij.shutdown();
+        CHECK(teardown == (std::vector<std::string>{"closeSecond", "~Second", "closeFirst", "~First"}));
+        CHECK(ij.getLiveStats().objects == 0u);
+        CHECK_THROWS_AS(ij.get<First>(), std::runtime_error);
+    }
+    teardown.clear();
+    {
+        Injector ij;
+        ij.bindImpl<First>();
+        ij.get<First>();
+    }
+    CHECK(teardown == (std::vector<std::string>{"closeFirst", "~First"})); // by the destructor.
+}
+
+namespace
+{
+    struct Table
+    {
+        SELFG(Table, "car")
+        INJECT(Table(IEngine *engine)) : engine(engine)
+        {
+        }
+        IEngine *engine;
+        int speed = 0;
+        float scale = 0;
+        std::string name;
+        Car *car = nullptr;
+        int inits = 0;
+        void init()
+        {
+            inits++;
+        }
+        FIELDS(FIELDK(speed, "speed"), FIELDD(scale, 2.5f), FIELDKD(name, "nm", "dflt"), FIELDK(car, "car"), ON_INIT(init))
+    };
+
+    struct Duplicated
+    {
+        SELF(Duplicated)
+        int a = 0;
+        FIELDS(FIELDD(a, 1), FIELDK(a, "a"))
+    };
+}
+
+TEST_CASE("Injector.FieldsTableInjectsMembers", "[injector]")
+{
+    static_assert(hasFields<Table>::value && !hasFields<Engine>::value);
+    Injector ij;
+    Options::Groups groups;
+    groups.groups["car"].add<int>("speed", 9);
+    bindCar(ij, groups);
+    ij.bindImpl<Table>();
+    ij.validate();
+
+    Table *table = ij.get<Table>();
+    CHECK(table->speed == 9);
+    CHECK(table->scale == 2.5f);
+    CHECK(table->name == "dflt");
+    CHECK(table->car == ij.get<Car>());
+    CHECK(table->inits == 1);
+
+    CHECK(errorOf([]()
+                      { AutoRegisteredObjects::find<Duplicated>(); })
+                  .find("already registered") != std::string::npos);
+}
+
+namespace
+{
+    struct Knob
+    {
+        SELFG(Knob, "knob")
+        int n = 0;
+        MEMBERK(n, "n")
+    };
+}
+
+TEST_CASE("Injector.ConfigMembersAreReadWhenInjecting", "[injector]")
+{
+    Injector ij;
+    Options::Groups groups;
+    groups.groups["knob"].add<int>("n", 1);
+    ij.bindPtr<Options::Groups>(&groups);
+    ij.bindImpl<Knob>();
+
+    std::unique_ptr<Knob> a(ij.get<Knob, Dynamic>());
+    CHECK(a->n == 1);
+    groups.groups["knob"].getOption("n")->getValueRef<int>() = 5;
+    std::unique_ptr<Knob> b(ij.get<Knob, Dynamic>());
+    CHECK(b->n == 5);
+}
+
+TEST_CASE("Injector.WriteWiringListsComponents", "[injector]")
+{
+    Injector ij;
+    Options::Groups groups;
+    bindCar(ij, groups);
+    std::ostringstream os;
+    ij.writeWiring(os);
+    std::string wiring = os.str();
+    std::string car = TypeIds::nameOf(typeid(Car));
+    INFO(wiring);
+    CHECK(wiring.find("component\t" + car + "\t" + car + "\n") != std::string::npos);
+    CHECK(wiring.find("arg\tpointer\t" + TypeIds::nameOf(typeid(IEngine)) + "\t1\n") != std::string::npos);
+    CHECK(wiring.find("init\tinit\n") != std::string::npos);
+}
+
+TEST_CASE("WorkerPool.WaitRethrowsTheFirstFailure", "[workerpool]")
+{
+    WorkerPool pool(2);
+    std::atomic<int> done{0};
+    for (int i = 0; i < 10; i++)
+    {
+        pool.submit([i, &done]()
+                    {
+                        if (i == 3)
+                        {
+                            throw std::runtime_error("task3");
+                        }
+                        done++; });
+    }
+    CHECK(errorOf([&pool]()
+                      { pool.wait(); }) == "task3");
+    CHECK(done == 9);
+    CHECK_NOTHROW(pool.wait());
+}
@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#include <fg/util/LiveConfig.h>
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <thread>
+
+using namespace fog;
+
+namespace
+{
+    Options::Groups groupsOf(int tick)
+    {
+        Options::Groups groups;
+        groups.groups["srv"].tryEmplace<int>("tick", tick);
+        return groups;
+    }
+}
+
+TEST_CASE("LiveConfig.ReadersSeeMonotonicVersions", "[liveconfig]")
+{
+    LiveConfig live(groupsOf(0));
+    std::atomic<bool> stop{false};
+    std::atomic<int> regressions{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++)
+    {
+        readers.emplace_back([&]()
+                             {
+                                 int last = 0;
+                                 while (!stop.load())
+                                 {
+                                     int tick = live.read().options.get<int>("srv", "tick", -1);
+                                     regressions += tick < last;
+                                     last = tick;
+                                 }
+                                 live.release(); });
+    }
+    for (int i = 1; i <= 200; i++)
+    {
+        live.publish(groupsOf(i));
+    }
+    std::shared_ptr<const LiveConfig::Snapshot> held = live.acquire();
+    stop = true;
+    for (std::thread &t : readers)
+    {
+        t.join();
+    }
+    CHECK(regressions == 0);
+    CHECK(held->options.get<int>("srv", "tick", 0) == 200);
+    CHECK(live.read().version == live.getVersion());
+}
+
+TEST_CASE("LiveConfig.InstancesKeepTheirOwnSnapshot", "[liveconfig]")
+{
+    LiveConfig a(groupsOf(1));
+    LiveConfig b(groupsOf(2));
+    const LiveConfig::Snapshot &sa = a.read();
+    const LiveConfig::Snapshot &sb = b.read();
+    a.publish(groupsOf(3));
+    CHECK(sa.options.get<int>("srv", "tick", 0) == 1); // valid until a is read again.
+    CHECK(sb.options.get<int>("srv", "tick", 0) == 2);
+    CHECK(a.read().options.get<int>("srv", "tick", 0) == 3);
+    {
+        LiveConfig c(groupsOf(4));
+        CHECK(c.read().options.get<int>("srv", "tick", 0) == 4);
+    }
+    LiveConfig d(groupsOf(5)); // may reuse the slot of c.
+    CHECK(d.read().options.get<int>("srv", "tick", 0) == 5);
+}
+
+TEST_CASE("LiveConfig.ReloadFromFiles", "[liveconfig]")
+{
+    LiveConfig live;
+    std::uint64_t version = live.reload({std::string(FOG_UTIL_TEST_DATA) + "/config.ini"}, false);
+    CHECK(live.read().version == version);
+    CHECK(live.read().options.get<int>("game", "speed", 0) == 5);
+}
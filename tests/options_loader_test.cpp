@@ -0,0 +1,235 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#include <fg/util/OptionsLoader.h>
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <filesystem>
+#include <sys/stat.h>
+#include <thread>
+
+using namespace fog;
+
+namespace
+{
+    const std::string data = FOG_UTIL_TEST_DATA;
+
+    // the line parser OptionsLoader had before the memory mapped one, as the reference of parity.
+    std::unordered_map<std::string, Options> legacyLoad(const std::string &file)
+    {
+        std::unordered_map<std::string, Options> optMap;
+        std::ifstream f(file);
+        std::string line;
+        std::string group;
+        while (std::getline(f, line))
+        {
+            while (!line.empty() && line[0] == ' ')
+            {
+                line = line.substr(1);
+            }
+            if (line.empty() || line[0] == '#' || (line[0] == '/' && line.length() > 1 && line[1] == '/'))
+            {
+                continue;
+            }
+            if (line[0] == '[')
+            {
+                group = line.substr(1, line.find(']') - 1);
+                continue;
+            }
+            Options &opts = optMap[group];
+            auto eq = line.find('=');
+            if (eq == std::string::npos)
+            {
+                continue;
+            }
+            std::string type = "string";
+            auto typeLeft = line.find("<");
+            std::string key = line.substr(0, eq);
+            std::string value = line.substr(eq + 1);
+            if (typeLeft != std::string::npos)
+            {
+                bool typeInV = (eq < typeLeft);
+                if (typeInV)
+                {
+                    typeLeft = typeLeft - eq - 1;
+                }
+                auto typeRight = (typeInV ? value : key).find_last_of(">");
+                if (typeInV)
+                {
+                    type = value.substr(typeLeft + 1, typeRight - typeLeft - 1);
+                    value = value.substr(typeRight + 1);
+                }
+                else
+                {
+                    type = key.substr(typeLeft + 1, typeRight - typeLeft - 1);
+                    key = key.substr(0, typeLeft);
+                }
+            }
+            if (type == "string")
+            {
+                opts.tryEmplace<std::string>(Options::Key(key), value);
+            }
+            else if (type == "float")
+            {
+                opts.tryEmplace<float>(Options::Key(key), std::stof(value));
+            }
+            else if (type == "int")
+            {
+                opts.tryEmplace<int>(Options::Key(key), std::stoi(value));
+            }
+            else if (type == "bool")
+            {
+                opts.tryEmplace<bool>(Options::Key(key), (value == "true" || value == "yes" || value == "Y" || value == "1"));
+            }
+            else if (type == "range2<int>")
+            {
+                std::vector<int> xyxy;
+                std::string str = value;
+                while (str.length() > 0)
+                {
+                    auto p2 = xyxy.size() < 3 ? str.find_first_of(",") : std::string::npos;
+                    xyxy.push_back(std::stoi(str.substr(0, p2)));
+                    str = p2 == std::string::npos ? "" : str.substr(p2 + 1);
+                }
+                Range2<int> v = xyxy.size() == 1   ? Range2<int>(xyxy[0])
+                                : xyxy.size() == 2 ? Range2<int>(xyxy[0], xyxy[1])
+                                : xyxy.size() == 3 ? Range2<int>(xyxy[0], xyxy[1], xyxy[2], xyxy[2])
+                                                   : Range2<int>(xyxy[0], xyxy[1], xyxy[2], xyxy[3]);
+                opts.tryEmplace<Range2<int>>(Options::Key(key), v);
+            }
+            else if (type == "unsigned int")
+            {
+                opts.tryEmplace<unsigned int>(Options::Key(key), static_cast<unsigned int>(std::stoul(value)));
+            }
+        }
+        return optMap;
+    }
+
+    template <typename T>
+    bool sameAs(const Options::Option &a, const Options::Option &b)
+    {
+        return a.getValueRef<T>() == b.getValueRef<T>();
+    }
+
+    template <>
+    bool sameAs<float>(const Options::Option &a, const Options::Option &b)
+    {
+        float x = a.getValueRef<float>();
+        float y = b.getValueRef<float>();
+        return x == y || (std::isnan(x) && std::isnan(y));
+    }
+
+    template <>
+    bool sameAs<Range2<int>>(const Options::Option &a, const Options::Option &b)
+    {
+        const Range2<int> &x = a.getValueRef<Range2<int>>();
+        const Range2<int> &y = b.getValueRef<Range2<int>>();
+        return x.x1 == y.x1 && x.y1 == y.y1 && x.x2 == y.x2 && x.y2 == y.y2;
+    }
+
+    bool same(const Options::Option &a, const Options::Option &b)
+    {
+        if (a.getType() != b.getType())
+        {
+            return false;
+        }
+        if (a.isType<int>())
+        {
+            return sameAs<int>(a, b);
+        }
+        if (a.isType<unsigned int>())
+        {
+            return sameAs<unsigned int>(a, b);
+        }
+        if (a.isType<float>())
+        {
+            return sameAs<float>(a, b);
+        }
+        if (a.isType<bool>())
+        {
+            return sameAs<bool>(a, b);
+        }
+        if (a.isType<Range2<int>>())
+        {
+            return sameAs<Range2<int>>(a, b);
+        }
+        return sameAs<std::string>(a, b);
+    }
+}
+
+TEST_CASE("OptionsLoader.ParityWithTheLineParser", "[optionsloader]")
+{
+    std::string file = data + "/parity.ini";
+    std::unordered_map<std::string, Options> expected = legacyLoad(file);
+    Options::Groups groups;
+    OptionsLoader().load({file}, groups, false);
+
+    REQUIRE(groups.groups.size() == expected.size());
+    for (const auto &pair : expected)
+    {
+        const Options &loaded = groups.groups[pair.first];
+        std::size_t count = 0;
+        pair.second.forEach([&](const std::string &key, const Options::Option *opt)
+                            {
+                                count++;
+                                const Options::Option *got = loaded.getOption(Options::Key(key));
+                                INFO(pair.first << "." << key);
+                                REQUIRE(got != nullptr);
+                                CHECK(same(*got, *opt)); });
+        std::size_t loadedCount = 0;
+        loaded.forEach([&loadedCount](const std::string &, const Options::Option *)
+                       { loadedCount++; });
+        INFO(pair.first);
+        CHECK(loadedCount == count);
+    }
+}
+
+TEST_CASE("OptionsLoader.ResolvesRefs", "[optionsloader]")
+{
+    Options::Groups groups;
+    OptionsLoader().load({data + "/config.ini"}, groups, true);
+    Options &game = groups.groups["game"];
+    CHECK(Options::get<int>(game, "speed", 0) == 5);
+    CHECK(Options::get<std::string>(game, "title", "") == "hello world");
+    CHECK(Options::get<int>(game, "alias", 0) == 5);
+
+    Options one;
+    OptionsLoader().load({data + "/config.ini"}, one, "game", false);
+    CHECK(Options::get<int>(one, "speed", 0) == 5);
+}
+
+TEST_CASE("OptionsLoader.StrictRejectsDuplicates", "[optionsloader]")
+{
+    Options::Groups groups;
+    CHECK_THROWS_AS(OptionsLoader().load({data + "/parity.ini"}, groups, true), std::runtime_error);
+    CHECK_THROWS_AS(OptionsLoader().load({data + "/none.ini"}, groups, true), std::runtime_error);
+}
+
+TEST_CASE("OptionsLoader.CrlfAndEmptyFiles", "[optionsloader]")
+{
+    Options::Groups groups;
+    OptionsLoader().load({data + "/crlf.ini", data + "/empty.ini"}, groups, true);
+    CHECK(Options::get<int>(groups.groups["a"], "x", 0) == 42);
+    CHECK(Options::get<std::string>(groups.groups["a"], "s", "") == "hi there");
+}
+
+TEST_CASE("OptionsLoader.ReadsFilesThatCannotBeMapped", "[optionsloader]")
+{
+    MappedFile status("/proc/self/status");
+    CHECK(status.view().find("Name:") != std::string_view::npos);
+
+    std::string fifo = (std::filesystem::temp_directory_path() / "fog-options-loader.fifo").string();
+    ::unlink(fifo.c_str());
+    REQUIRE(::mkfifo(fifo.c_str(), 0600) == 0);
+    std::thread writer([&fifo]()
+                       {
+                           std::ofstream os(fifo);
+                           os << "[pipe]\nx=<int>7\n"; });
+    Options::Groups groups;
+    OptionsLoader().load({fifo}, groups, true);
+    writer.join();
+    ::unlink(fifo.c_str());
+    CHECK(Options::get<int>(groups.groups["pipe"], "x", 0) == 7);
+}
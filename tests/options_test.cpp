@@ -0,0 +1,197 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#include <fg/util/Options.h>
+#include <fg/util/Property.h>
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+using namespace fog;
+
+TEST_CASE("Options.KeyHashesAtCompileTime", "[options]")
+{
+    static_assert("speed"_k.hash == Options::Key::hashOf("speed"));
+    static_assert("speed"_k == Options::Key("speed"));
+    static_assert(!std::is_convertible_v<const std::string &, Options::Key>, "a key from a string is explicit.");
+    Options opts;
+    opts.add<int>("speed", 5);
+    std::string name = "speed";
+    CHECK(Options::get<int>(opts, "speed"_k, 0) == 5);
+    CHECK(Options::get<int>(opts, Options::Key(name), 0) == 5);
+    CHECK(Options::get<int>(opts, "none", 1) == 1);
+    CHECK_THROWS_AS(Options::get<float>(opts, "speed", 0), std::runtime_error);
+}
+
+TEST_CASE("Options.OptionCopiesAndMovesItsValue", "[options]")
+{
+    Options::Option a("a", std::string(40, 'x'));
+    Options::Option b = a;
+    Options::Option c = std::move(a);
+    CHECK(b.getValueRef<std::string>() == std::string(40, 'x'));
+    CHECK(std::any_cast<std::string>(c.getValue()) == std::string(40, 'x'));
+    CHECK_FALSE(a.isType<std::string>());
+    CHECK_THROWS_AS(a.getValue(), std::runtime_error);
+    CHECK_THROWS_AS(c.getValueRef<int>(), std::bad_any_cast);
+
+    Options::Option small("n", 3);
+    small = b;
+    CHECK(small.getValueRef<std::string>() == std::string(40, 'x'));
+    CHECK(small.name == "n"); // the key of the option in its Options views the name.
+    small = Options::Option("m", 4);
+    CHECK(small.getValueRef<int>() == 4);
+    CHECK(small.name == "n");
+}
+
+TEST_CASE("Options.MergeKeepsAndReplaceAllOverrides", "[options]")
+{
+    Options a;
+    a.add<int>("x", 1);
+    Options b;
+    b.add<int>("x", 2);
+    b.add<int>("y", 3);
+
+    Options merged = a;
+    merged.merge(b);
+    CHECK(Options::get<int>(merged, "x", 0) == 1);
+    CHECK(Options::get<int>(merged, "y", 0) == 3);
+
+    a.replaceAll(b);
+    CHECK(Options::get<int>(a, "x", 0) == 2);
+    CHECK(Options::get<int>(a, "y", 0) == 3);
+}
+
+TEST_CASE("Options.SharedOptionsAreCopiedOnWrite", "[options]")
+{
+    Options defaults;
+    defaults.tryEmplace<std::string>("title", std::string(40, 'x'));
+    Options copy = defaults;
+    CHECK(std::as_const(copy).getOption("title") == std::as_const(defaults).getOption("title"));
+
+    copy.forEach([](const std::string &, const Options::Option *) {}); // read only, still shared.
+    CHECK(std::as_const(copy).getOption("title") == std::as_const(defaults).getOption("title"));
+    copy.forEach([](const std::string &, Options::Option *) {});
+    CHECK(std::as_const(copy).getOption("title") != std::as_const(defaults).getOption("title"));
+
+    copy.getOption("title")->getValueRef<std::string>() = "changed";
+    CHECK(Options::get<std::string>(defaults, "title", "") == std::string(40, 'x'));
+    CHECK(Options::get<std::string>(copy, "title", "") == "changed");
+}
+
+TEST_CASE("Options.PointersHandedOutNeverAlias", "[options]")
+{
+    Options a;
+    Options::Option *hp = a.add<int>("hp", 1);
+    Options merged;
+    merged.merge(a);
+    Options copy(a);
+    Options replaced;
+    replaced.replaceAll(a);
+
+    hp->getValueRef<int>() = 5;
+    CHECK(Options::get<int>(a, "hp", 0) == 5);
+    CHECK(Options::get<int>(merged, "hp", 0) == 1);
+    CHECK(Options::get<int>(copy, "hp", 0) == 1);
+    CHECK(Options::get<int>(replaced, "hp", 0) == 1);
+}
+
+TEST_CASE("Options.FrozenLooksUpByGroupAndName", "[options]")
+{
+    Options::Groups groups;
+    groups.groups["base"].add<int>("speed", 5);
+    groups.groups["base"].add<std::string>("name", std::string("hello"));
+    for (int i = 0; i < 100; i++)
+    {
+        groups.groups["big"].add<int>(Options::Key("k" + std::to_string(i)), i);
+    }
+    Options::Frozen frozen = groups.freeze();
+
+    Options::Frozen::View base = frozen.group("base"_k);
+    CHECK(base.size() == 2u);
+    CHECK(base.get<int>("speed"_k, 0) == 5);
+    CHECK(*base.find<std::string>("name") == "hello");
+    CHECK(base.find<int>("none") == nullptr);
+    CHECK_THROWS_AS(base.get<int>("name", 0), std::runtime_error);
+    Options::Frozen::View big = frozen.group("big");
+    for (int i = 0; i < 100; i++)
+    {
+        CHECK(big.get<int>(Options::Key("k" + std::to_string(i)), -1) == i);
+    }
+    CHECK(frozen.group("none").empty());
+    CHECK(frozen.get<int>("none", "x", 4) == 4);
+}
+
+TEST_CASE("Options.LayersReturnTheTopmostOption", "[options]")
+{
+    auto defaults = std::make_shared<Options>();
+    defaults->tryEmplace<int>("w", 800);
+    defaults->tryEmplace<int>("h", 600);
+    auto overrides = std::make_shared<Options>();
+    overrides->tryEmplace<int>("w", 1024);
+
+    Options::Layers layers;
+    layers.push(defaults);
+    layers.push(overrides);
+    CHECK(layers.get<int>("w", 0) == 1024);
+    CHECK(layers.get<int>("h", 0) == 600);
+    CHECK(layers.get<int>("none", 5) == 5);
+    int visible = 0;
+    layers.forEach([&visible](const std::string &, const Options::Option *)
+                   { visible++; });
+    CHECK(visible == 2);
+
+    Options flat = layers.flatten();
+    CHECK(Options::get<int>(flat, "w", 0) == 1024);
+    CHECK(std::as_const(flat).getOption("h") == std::as_const(*defaults).getOption("h"));
+}
+
+TEST_CASE("Options.HandleResolvesAgainAfterChanges", "[options]")
+{
+    Options opts;
+    opts.add<int>("tick", 30);
+    Options::Handle<int> tick = opts.handle<int>("tick", 0);
+    Options::Handle<float> scale = opts.handle<float>("scale", 2.0f);
+    CHECK(*tick == 30);
+    CHECK(*scale == 2.0f);
+    CHECK_FALSE(scale.exists());
+
+    opts.getOption("tick")->getValueRef<int>() = 60;
+    CHECK(*tick == 60);
+    opts.add<float>("scale", 3.0f);
+    CHECK(*scale == 3.0f);
+    opts.set(std::make_shared<Options::Option>(std::string("tick"), 90));
+    CHECK(*tick == 90);
+    CHECK_THROWS_AS(opts.handle<std::string>("tick", ""), std::runtime_error);
+}
+
+TEST_CASE("Options.HandleSurvivesAssignment", "[options]")
+{
+    Options opts;
+    opts.tryEmplace<std::string>("s", std::string(40, 'a'));
+    Options::Handle<std::string> s = opts.handle<std::string>("s", "none");
+    {
+        Options other;
+        other.tryEmplace<std::string>("s", std::string(40, 'b'));
+        opts = other;
+    }
+    CHECK(*s == std::string(40, 'b'));
+    {
+        Options other;
+        other.tryEmplace<std::string>("s", std::string(40, 'c'));
+        opts = std::move(other);
+    }
+    CHECK(*s == std::string(40, 'c'));
+    Options moved(std::move(opts));
+    CHECK(*s == "none");
+}
+
+TEST_CASE("Property.LaterBindIsResolvedWhenCreated", "[property]")
+{
+    Property::Bag bag;
+    Property::Ref<int> later = bag.getProperty<int>("x", false);
+    bag.createProperty<int>("x", 9);
+    CHECK(static_cast<int &>(later) == 9);
+    Property::Ref<int> now = bag.getProperty<int>("x");
+    CHECK(static_cast<int &>(now) == 9);
+    CHECK_THROWS_AS(bag.getProperty<int>("none"), std::runtime_error);
+}
@@ -0,0 +1,181 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+#include <fg/util/StaticInjector.h>
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+using namespace fog;
+
+namespace
+{
+    struct IEngine
+    {
+        virtual ~IEngine() = default;
+        virtual int power() = 0;
+    };
+
+    struct Engine : IEngine
+    {
+        int power() override
+        {
+            return 42;
+        }
+    };
+
+    struct Position
+    {
+        int x = 3;
+    };
+
+    struct Car
+    {
+        SELFG(Car, "car")
+        INJECT(Car(IEngine *engine, Position position, Lazy<Position> lazy, Provider<IEngine> provider))
+            : engine(engine), position(position), lazy(lazy), provider(provider)
+        {
+        }
+        IEngine *engine;
+        Position position;
+        Lazy<Position> lazy;
+        Provider<IEngine> provider;
+        int speed = 0;
+        MEMBERKD(speed, "speed", 5)
+        bool inited = false;
+        INIT(init)()
+        {
+            inited = true;
+        }
+    };
+
+    struct Driver
+    {
+        SELFG(Driver, "driver")
+        int n = 0;
+        MEMBERK(n, "n")
+        Car *car = nullptr;
+        MEMBERK(car, "car")
+    };
+
+    struct Counter
+    {
+        SELF(Counter)
+        int inits = 0;
+        void init()
+        {
+            inits++;
+        }
+        FIELDS(ON_INIT(init))
+    };
+
+    struct Gearbox : IEngine
+    {
+        static inline int made = 0;
+        Gearbox()
+        {
+            made++;
+        }
+        int power() override
+        {
+            return 7;
+        }
+    };
+
+    struct Dashboard
+    {
+        SELFG(Dashboard, "dash")
+        IEngine *engine = nullptr;
+        Position position;
+        Lazy<Position> lazy;
+        float scale = 0;
+        int *level = nullptr;
+        std::string title;
+        int order = 0;
+        void init()
+        {
+            order = engine && lazy.get() ? 1 : -1;
+        }
+        FIELDS(FIELDK(engine, "engine"), FIELDK(position, "position"), FIELDK(lazy, "lazy"), FIELDD(scale, 2.5f),
+               FIELDK(level, "level"), FIELDKD(title, "title", "none"), ON_INIT(init))
+    };
+
+    struct Plain
+    {
+        SELF(Plain)
+        int x = 0;
+        MEMBERD(x, 5)
+    };
+}
+
+TEST_CASE("StaticInjector.CreatesAllBindings", "[staticinjector]")
+{
+    StaticInjector<StaticBind<IEngine, Engine>, Car, Position> sij;
+    Car *car = sij.get<Car>();
+    CHECK(car->engine == sij.get<IEngine>());
+    CHECK(car->engine->power() == 42);
+    CHECK(car->position.x == 3);
+    CHECK(car->lazy.get() == sij.get<Position>());
+    CHECK(car->provider.get() == sij.get<IEngine>());
+    CHECK(car->speed == 5);
+    CHECK(car->inited);
+}
+
+TEST_CASE("StaticInjector.MembersFromGroups", "[staticinjector]")
+{
+    Options::Groups groups;
+    groups.groups["car"].add<int>("speed", 9);
+    groups.groups["driver"].add<int>("n", 2);
+    StaticInjector<StaticBind<IEngine, Engine>, Car, Position, Driver> sij(&groups);
+    CHECK(sij.get<Car>()->speed == 9);
+    CHECK(sij.get<Driver>()->n == 2);
+    CHECK(sij.get<Driver>()->car == sij.get<Car>());
+}
+
+TEST_CASE("StaticInjector.MissingConfigThrows", "[staticinjector]")
+{
+    using Injector = StaticInjector<StaticBind<IEngine, Engine>, Car, Position, Driver>;
+    CHECK_THROWS_AS(Injector(), std::runtime_error);
+}
+
+TEST_CASE("StaticInjector.FieldsTableInit", "[staticinjector]")
+{
+    StaticInjector<Counter> sij;
+    CHECK(sij.get<Counter>()->inits == 1);
+}
+
+TEST_CASE("StaticInjector.BindingsOfOneImplShareTheInstance", "[staticinjector]")
+{
+    Gearbox::made = 0;
+    StaticInjector<StaticBind<IEngine, Gearbox>, Gearbox> sij;
+    CHECK(Gearbox::made == 1);
+    CHECK(sij.get<IEngine>() == static_cast<IEngine *>(sij.get<Gearbox>()));
+}
+
+TEST_CASE("StaticInjector.FieldsTableMembers", "[staticinjector]")
+{
+    Options::Groups groups;
+    groups.groups["dash"].add<int>("level", 3);
+    StaticInjector<StaticBind<IEngine, Engine>, Position, Dashboard> sij(&groups);
+    Dashboard *dash = sij.get<Dashboard>();
+    CHECK(dash->engine == sij.get<IEngine>());
+    CHECK(dash->position.x == 3);
+    CHECK(dash->lazy.get() == sij.get<Position>());
+    CHECK(dash->scale == 2.5f);
+    CHECK(*dash->level == 3);
+    CHECK(dash->title == "none");
+    CHECK(dash->order == 1);
+
+    CHECK_THROWS_AS((StaticInjector<StaticBind<IEngine, Engine>, Position, Dashboard>(nullptr)), std::runtime_error); // level has no default.
+    groups.groups["dash"].add<std::string>("title", std::string("x"));
+    groups.groups["dash"].getOption("level")->getValueRef<int>() = 4;
+    StaticInjector<StaticBind<IEngine, Engine>, Position, Dashboard> other(&groups);
+    CHECK(other.get<Dashboard>()->title == "x");
+    CHECK(*other.get<Dashboard>()->level == 4);
+}
+
+TEST_CASE("StaticInjector.DefaultValueWithoutGroup", "[staticinjector]")
+{
+    StaticInjector<Plain> sij;
+    CHECK(sij.get<Plain>()->x == 5);
+}
@@ -0,0 +1,247 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+/**
+ * Generate the wiring of components as plain C++ from the metadata written by
+ * Injector::writeWiring, see fg/util/Wiring.h.
+ *
+ * usage: fog-wiring-gen <metadata> <output.cpp> [header...]
+ *
+ * The headers declaring the components are included by the generated translation unit, which
+ * must be linked into the application. A component gets a generated create function only if all
+ * the arguments of its INJECT constructor are pointers or references of bound types, the members
+ * assigned by the generated code must be accessible. A type that would be written to the output
+ * must be nameable from it, the generation fails on a type in an anonymous namespace, a lambda,
+ * or a name demangled with its class key(as by MSVC).
+ */
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Arg
+    {
+        std::string kind;
+        std::string type;
+        bool bound;
+    };
+
+    struct Member
+    {
+        std::string name;
+        std::string type;
+        bool pointer;
+        bool bound;
+        bool lazy;
+    };
+
+    struct Record
+    {
+        std::string impl;
+        std::vector<Arg> args;
+        std::vector<Member> members;
+        std::string init;
+    };
+
+    std::vector<std::string> split(const std::string &line)
+    {
+        std::vector<std::string> ret;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, '\t'))
+        {
+            ret.push_back(field);
+        }
+        return ret;
+    }
+
+    std::vector<Record> parse(std::istream &is)
+    {
+        std::vector<Record> ret;
+        std::string line;
+        int lineNo = 0;
+        while (std::getline(is, line))
+        {
+            lineNo++;
+            std::vector<std::string> fields = split(line);
+            if (fields.empty())
+            {
+                continue;
+            }
+            const std::string &tag = fields[0];
+            if (tag == "component" && fields.size() == 3)
+            {
+                ret.push_back(Record{fields[1], {}, {}, {}});
+            }
+            else if (ret.empty())
+            {
+                throw std::runtime_error("record outside of component at line " + std::to_string(lineNo));
+            }
+            else if (tag == "arg" && fields.size() == 4)
+            {
+                ret.back().args.push_back(Arg{fields[1], fields[2], fields[3] == "1"});
+            }
+            else if (tag == "member" && fields.size() == 6)
+            {
+                ret.back().members.push_back(Member{fields[1], fields[2], fields[3] == "1", fields[4] == "1", fields[5] == "1"});
+            }
+            else if (tag == "init" && fields.size() == 2)
+            {
+                ret.back().init = fields[1];
+            }
+            else if (tag != "end")
+            {
+                throw std::runtime_error("bad record at line " + std::to_string(lineNo) + ": " + line);
+            }
+        }
+        return ret;
+    }
+
+    bool isIdentChar(char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    /**
+     * The type name as written in the generated code, which must compile: a demangled name of a
+     * type in an anonymous namespace or of a lambda cannot be named, nor a name with its class
+     * key as demangled by MSVC(e.g. "struct Foo").
+     */
+    const std::string &spell(const std::string &type)
+    {
+        for (const char *bad : {"(anonymous namespace)", "{anonymous}", "`anonymous namespace'", "<lambda", "{lambda"})
+        {
+            if (type.find(bad) != std::string::npos)
+            {
+                throw std::runtime_error("type cannot be named in generated code: " + type + "(anonymous namespace or lambda)");
+            }
+        }
+        for (const std::string key : {"struct ", "class ", "union ", "enum "})
+        {
+            for (std::size_t pos = type.find(key); pos != std::string::npos; pos = type.find(key, pos + 1))
+            {
+                if (pos == 0 || !isIdentChar(type[pos - 1]))
+                {
+                    throw std::runtime_error("type cannot be named in generated code: " + type + "(class key in the demangled name)");
+                }
+            }
+        }
+        return type;
+    }
+
+    bool canCreate(const Record &rec)
+    {
+        for (const Arg &arg : rec.args)
+        {
+            if (!arg.bound || (arg.kind != "pointer" && arg.kind != "reference"))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void generate(const std::vector<Record> &recs, const std::string &source, const std::vector<std::string> &headers, std::ostream &os)
+    {
+        os << "// generated by fog-wiring-gen from " << source << ", do not edit.\n";
+        for (const std::string &header : headers)
+        {
+            os << "#include \"" << header << "\"\n";
+        }
+        os << "#include <fg/util/Injector.h>\n\n";
+        os << "namespace\n{\n";
+        std::vector<std::string> entries;
+        for (std::size_t i = 0; i < recs.size(); i++)
+        {
+            const Record &rec = recs[i];
+            std::string create = "nullptr";
+            std::string inject = "nullptr";
+            if (canCreate(rec))
+            {
+                create = "&create" + std::to_string(i);
+                os << "    // " << rec.impl << "\n";
+                os << "    void *create" << i << "(fog::Injector &" << (rec.args.empty() ? "" : "ij") << ", fog::Arena *arena)\n    {\n";
+                os << "        return fog::Wiring::make<" << spell(rec.impl) << ">(arena";
+                for (const Arg &arg : rec.args)
+                {
+                    os << ", " << (arg.kind == "reference" ? "*" : "") << "ij.get<" << spell(arg.type) << ">()";
+                }
+                os << ");\n    }\n\n";
+            }
+            std::string names;
+            std::vector<const Member *> assigned;
+            for (const Member &member : rec.members)
+            {
+                if (member.bound && !member.lazy)
+                {
+                    assigned.push_back(&member);
+                    names += (names.empty() ? "\"" : ", \"") + member.name + "\"";
+                }
+            }
+            if (!assigned.empty() || !rec.init.empty())
+            {
+                inject = "&inject" + std::to_string(i);
+                os << "    // " << rec.impl << "\n";
+                os << "    void inject" << i << "(void *ptr, fog::Injector &" << (assigned.empty() ? "" : "ij") << ")\n    {\n";
+                os << "        " << spell(rec.impl) << " *obj = static_cast<" << rec.impl << " *>(ptr);\n";
+                for (const Member *member : assigned)
+                {
+                    os << "        obj->" << member->name << " = " << (member->pointer ? "" : "*") << "ij.get<" << spell(member->type) << ">();\n";
+                }
+                if (!rec.init.empty())
+                {
+                    os << "        obj->" << rec.init << "();\n";
+                }
+                os << "    }\n\n";
+            }
+            if (create != "nullptr" || inject != "nullptr")
+            {
+                entries.push_back("{typeid(" + rec.impl + "), " + create + ", " + inject + ", {" + names + "}, " + (rec.init.empty() ? "false" : "true") + "}");
+            }
+        }
+        os << "    fog::Wiring::Registrar registrar{\n";
+        for (const std::string &entry : entries)
+        {
+            os << "        " << entry << ",\n";
+        }
+        os << "    };\n}\n";
+    }
+};
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: fog-wiring-gen <metadata> <output.cpp> [header...]" << std::endl;
+        return 2;
+    }
+    try
+    {
+        std::ifstream is(argv[1]);
+        if (!is)
+        {
+            throw std::runtime_error(std::string("cannot open metadata file: ") + argv[1]);
+        }
+        std::vector<Record> recs = parse(is);
+        std::vector<std::string> headers(argv + 3, argv + argc);
+        std::ofstream os(argv[2]);
+        if (!os)
+        {
+            throw std::runtime_error(std::string("cannot open output file: ") + argv[2]);
+        }
+        generate(recs, argv[1], headers, os);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "fog-wiring-gen: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
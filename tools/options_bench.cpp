@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Mao-Pao-Tong Workshop
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+/**
+ * Throughput of OptionsLoader in MB/s, on a generated config of the given size.
+ *
+ * usage: fog-options-bench [size in MB, default 40] [rounds, default 5] [--min-mbps <MB/s>]
+ *
+ * The config has groups of options of every supported type, each round loads it into new
+ * groups, the best round is reported. With --min-mbps the exit code is 2 if the best round is
+ * below the given throughput, so the bench can run as a test.
+ */
+#include <fg/util/OptionsLoader.h>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+namespace
+{
+    std::string generate(std::size_t bytes)
+    {
+        std::string text;
+        text.reserve(bytes + 256);
+        for (int g = 0; text.size() < bytes; g++)
+        {
+            text += "[group" + std::to_string(g) + "]\n";
+            for (int i = 0; i < 1000 && text.size() < bytes; i++)
+            {
+                std::string n = std::to_string(i);
+                text += "hp" + n + "=<int>" + std::to_string(i * 37) + "\n";
+                text += "rate" + n + "=<float>" + std::to_string(i * 0.25) + "\n";
+                text += "name" + n + "=unit name " + n + "\n";
+                text += "on" + n + "=<bool>true\n";
+                text += "area" + n + "=<range2<int>>0,0," + n + "," + n + "\n";
+                text += "cost" + n + "<unsigned int>=" + std::to_string(i * 3) + "\n";
+            }
+            text += "base=<ref>group" + std::to_string(g) + ".hp1\n";
+        }
+        return text;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> args;
+    double minMbps = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--min-mbps" && i + 1 < argc)
+        {
+            minMbps = std::stod(argv[++i]);
+        }
+        else
+        {
+            args.push_back(argv[i]);
+        }
+    }
+    std::size_t mb = args.size() > 0 ? std::stoul(args[0]) : 40;
+    int rounds = args.size() > 1 ? std::stoi(args[1]) : 5;
+    std::string file = (std::filesystem::temp_directory_path() / "fog-options-bench.ini").string();
+    double best = 0;
+    try
+    {
+        std::string text = generate(mb * 1024 * 1024);
+        {
+            std::ofstream os(file, std::ios::binary);
+            os << text;
+        }
+        double mbs = static_cast<double>(text.size()) / (1024 * 1024);
+        for (int r = 0; r < rounds; r++)
+        {
+            fog::Options::Groups groups;
+            auto start = std::chrono::steady_clock::now();
+            fog::OptionsLoader().load({file}, groups, true);
+            std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+            best = std::max(best, mbs / secs.count());
+            std::cout << "round " << r << ": " << mbs << " MB in " << secs.count() << " s, " << mbs / secs.count() << " MB/s" << std::endl;
+        }
+        std::cout << "best: " << best << " MB/s" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "fog-options-bench: " << e.what() << std::endl;
+        std::remove(file.c_str());
+        return 1;
+    }
+    std::remove(file.c_str());
+    if (best < minMbps)
+    {
+        std::cerr << "fog-options-bench: " << best << " MB/s is below the minimum of " << minMbps << " MB/s" << std::endl;
+        return 2;
+    }
+    return 0;
+}